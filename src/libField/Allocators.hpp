@@ -0,0 +1,415 @@
+#ifndef Allocators_hpp
+#define Allocators_hpp
+
+/** @file Allocators.hpp
+ * @brief Allocators that can be used for field storage.
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * The element array used by a Field is selected with its ARRAYND template
+ * parameter. The aliases at the bottom of this file are boost::multi_array's
+ * that use the allocators defined here, so they can be passed as ARRAYND.
+ *
+ * @code
+ * // elements are aligned to 64 bytes
+ * Field<double, 3, double, alignedArrayND> F(100, 100, 100);
+ * // elements are aligned to 64 bytes and backed by huge pages if possible
+ * Field<double, 3, double, hugePageArrayND> G(1000, 1000, 1000);
+ * @endcode
+ *
+ * The shared objects that hold a field's element array, coordinate system, and
+ * axes are allocated with (a rebound copy of) the allocator used by the
+ * arrays, see allocate_shared_like(). So a field that uses arena arrays for
+ * both its elements and its axes is allocated entirely from the arena.
+ */
+
+#include <algorithm>
+#include <boost/multi_array.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "Utils.hpp"
+
+namespace allocators {
+
+/** Size of a (transparent) huge page on the platforms that support them. */
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+/**
+ * Allocate n bytes aligned to align bytes. align must be a power of two and a
+ * multiple of sizeof(void*). Throws std::bad_alloc on failure.
+ */
+inline void* aligned_malloc(size_t n, size_t align) {
+    if (n == 0) n = align;
+#if defined(_WIN32)
+    void* p = _aligned_malloc(n, align);
+    if (!p) throw std::bad_alloc();
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align, n) != 0) throw std::bad_alloc();
+#endif
+    return p;
+}
+
+inline void aligned_free(void* p) {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+/**
+ * Allocate n bytes that may be backed by transparent huge pages.
+ *
+ * Allocations of at least one huge page are aligned to, and padded to a
+ * multiple of, the huge page size, and the kernel is advised to back them with
+ * huge pages (on Linux). Smaller allocations are just aligned to align bytes.
+ */
+inline void* huge_page_malloc(size_t n, size_t align) {
+    if (n < huge_page_size) return aligned_malloc(n, align);
+    n = (n + huge_page_size - 1) / huge_page_size * huge_page_size;
+    void* p = aligned_malloc(n, std::max(align, huge_page_size));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // this is only a hint, the memory is still usable if it fails.
+    madvise(p, n, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+
+/**
+ * An allocator that returns memory aligned to ALIGN bytes, and optionally
+ * backed by transparent huge pages (see huge_page_malloc()).
+ *
+ * Aligning field elements to (at least) the cache line size keeps vector
+ * loads from straddling cache lines. Huge pages reduce TLB misses when
+ * traversing fields that are several GB in size.
+ */
+template <typename T, size_t ALIGN = 64, bool HUGEPAGES = false>
+class AlignedAllocator {
+    static_assert(ALIGN >= alignof(T) && ALIGN % sizeof(void*) == 0 &&
+                      (ALIGN & (ALIGN - 1)) == 0,
+                  "ALIGN must be a power of two that is a multiple of "
+                  "sizeof(void*) and alignof(T).");
+
+   public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, ALIGN, HUGEPAGES> other;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGN, HUGEPAGES>&) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) throw std::bad_alloc();
+        const size_t bytes = n * sizeof(T);
+        return static_cast<T*>(HUGEPAGES ? huge_page_malloc(bytes, ALIGN)
+                                         : aligned_malloc(bytes, ALIGN));
+    }
+
+    void deallocate(T* p, size_t) { aligned_free(p); }
+};
+
+template <typename T, typename U, size_t ALIGN, bool HUGEPAGES>
+bool operator==(const AlignedAllocator<T, ALIGN, HUGEPAGES>&,
+                const AlignedAllocator<U, ALIGN, HUGEPAGES>&) {
+    return true;
+}
+template <typename T, typename U, size_t ALIGN, bool HUGEPAGES>
+bool operator!=(const AlignedAllocator<T, ALIGN, HUGEPAGES>&,
+                const AlignedAllocator<U, ALIGN, HUGEPAGES>&) {
+    return false;
+}
+
+/**
+ * An aligned allocator (see AlignedAllocator) that initializes memory in
+ * parallel.
+ *
+ * Operating systems place a page of memory on the NUMA node of the thread
+ * that first writes to it. boost::multi_array initializes its elements
+ * serially in the constructing thread, which puts every page of a field on
+ * one node, so parallel loops over the field run at the bandwidth of a
+ * single node. This allocator zeros newly allocated memory in parallel, with
+ * the same static partition (detail::for_each_block) that the field
+ * operators use, so each page is placed on the node of the thread that will
+ * process it. For trivial types, default constructing an element is then a
+ * no-op (the element is already zero), so the serial pass does not touch the
+ * memory again.
+ */
+template <typename T, size_t ALIGN = 64, bool HUGEPAGES = false>
+class FirstTouchAllocator : public AlignedAllocator<T, ALIGN, HUGEPAGES> {
+   public:
+    template <typename U>
+    struct rebind {
+        typedef FirstTouchAllocator<U, ALIGN, HUGEPAGES> other;
+    };
+
+    FirstTouchAllocator() = default;
+    template <typename U>
+    FirstTouchAllocator(const FirstTouchAllocator<U, ALIGN, HUGEPAGES>&) {}
+
+    T* allocate(size_t n) {
+        T* p = AlignedAllocator<T, ALIGN, HUGEPAGES>::allocate(n);
+        char* c = reinterpret_cast<char*>(p);
+        // a single block would be touched by one thread anyway, so small
+        // allocations (i.e. shared_ptr control blocks) are zeroed without
+        // starting a parallel region.
+        if (n <= detail::block_size) {
+            std::memset(c, 0, n * sizeof(T));
+            return p;
+        }
+        detail::for_each_block(n, [&](size_t b, size_t e) {
+            std::memset(c + b * sizeof(T), 0, (e - b) * sizeof(T));
+        });
+        return p;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        construct_imp(
+            p, std::integral_constant<bool, sizeof...(Args) == 0 &&
+                                                std::is_trivial<U>::value>(),
+            std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* p) {
+        p->~U();
+    }
+
+   protected:
+    template <typename U>
+    void construct_imp(U* p, std::true_type) {}
+    template <typename U, typename... Args>
+    void construct_imp(U* p, std::false_type, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T, typename U, size_t ALIGN, bool HUGEPAGES>
+bool operator==(const FirstTouchAllocator<T, ALIGN, HUGEPAGES>&,
+                const FirstTouchAllocator<U, ALIGN, HUGEPAGES>&) {
+    return true;
+}
+template <typename T, typename U, size_t ALIGN, bool HUGEPAGES>
+bool operator!=(const FirstTouchAllocator<T, ALIGN, HUGEPAGES>&,
+                const FirstTouchAllocator<U, ALIGN, HUGEPAGES>&) {
+    return false;
+}
+
+/**
+ * A memory arena (or region) that many small objects can be allocated from.
+ *
+ * Memory is handed out from large chunks by incrementing an offset, and is
+ * only returned when the arena is released (or destroyed). This makes
+ * allocation very cheap, and objects that are allocated together (i.e. a batch
+ * of small fields) end up next to each other in memory.
+ *
+ * Objects allocated from an arena must not be used after the arena is
+ * released. An arena is not thread safe, each thread should use its own.
+ */
+class Arena {
+   public:
+    explicit Arena(size_t chunk_size = 1024 * 1024) : chunk_size(chunk_size) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() { release(); }
+
+    /** Allocate n bytes aligned to align bytes (a power of two). */
+    void* allocate(size_t n, size_t align) {
+        std::uintptr_t p = (top + align - 1) & ~std::uintptr_t(align - 1);
+        if (chunks.empty() || p + n > end) {
+            // requests larger than the chunk size get their own chunk
+            const size_t size = std::max(chunk_size, n + align);
+            chunks.push_back(aligned_malloc(size, 64));
+            top = reinterpret_cast<std::uintptr_t>(chunks.back());
+            end = top + size;
+            capacity += size;
+            p = (top + align - 1) & ~std::uintptr_t(align - 1);
+        }
+        top = p + n;
+        used += n;
+        return reinterpret_cast<void*>(p);
+    }
+
+    /** Free all of the memory allocated from the arena. */
+    void release() {
+        for (auto c : chunks) aligned_free(c);
+        chunks.clear();
+        top = end = 0;
+        used = capacity = 0;
+    }
+
+    /** Number of bytes handed out by allocate() since the last release. */
+    size_t bytes_used() const { return used; }
+    /** Number of bytes reserved from the system. */
+    size_t bytes_reserved() const { return capacity; }
+
+    /** The arena that ArenaAllocator's allocate from on this thread, or
+     * nullptr. Set with ArenaScope. */
+    static Arena*& current() {
+        static thread_local Arena* arena = nullptr;
+        return arena;
+    }
+
+   protected:
+    size_t chunk_size;
+    std::vector<void*> chunks;
+    std::uintptr_t top = 0, end = 0;
+    size_t used = 0, capacity = 0;
+};
+
+/**
+ * Make an arena the current arena of this thread for the lifetime of the
+ * scope object. Scopes can be nested.
+ *
+ * @code
+ * Arena arena;
+ * std::vector<Field<double, 1, double, arenaArrayND, arenaArray1D>> spectra;
+ * {
+ *   ArenaScope scope(arena);
+ *   for (size_t i = 0; i < 10000; ++i) spectra.emplace_back(100);
+ * }
+ * @endcode
+ */
+class ArenaScope {
+   public:
+    explicit ArenaScope(Arena& arena) : prev(Arena::current()) {
+        Arena::current() = &arena;
+    }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+    ~ArenaScope() { Arena::current() = prev; }
+
+   protected:
+    Arena* prev;
+};
+
+/**
+ * An allocator that allocates from the arena that was current (see ArenaScope)
+ * when it was constructed, or from the heap if there was none. Memory
+ * allocated from an arena is not freed by deallocate(), it is freed when the
+ * arena is released.
+ *
+ * Copies of an allocator (and arrays copied from an array that uses it) keep
+ * allocating from the same arena.
+ */
+template <typename T>
+class ArenaAllocator {
+   public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    ArenaAllocator() : arena(Arena::current()) {}
+    explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.getArena()) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) throw std::bad_alloc();
+        if (!arena) return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        if (!arena) ::operator delete(p);
+    }
+
+    Arena* getArena() const { return arena; }
+
+   protected:
+    Arena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return !(a == b);
+}
+
+/** The allocator used by array type A (std::allocator for other types). */
+template <typename A>
+struct AllocatorOf {
+    typedef std::allocator<A> type;
+};
+template <typename T, size_t N, typename Alloc>
+struct AllocatorOf<boost::multi_array<T, N, Alloc>> {
+    typedef Alloc type;
+};
+
+/**
+ * Create a shared_ptr to a new T (like std::make_shared), allocating the
+ * object and its control block with the allocator used by array type A.
+ */
+template <typename T, typename A, typename... Args>
+std::shared_ptr<T> allocate_shared_like(Args&&... args) {
+    typedef typename std::allocator_traits<typename AllocatorOf<
+        A>::type>::template rebind_alloc<T>
+        alloc_type;
+    return std::allocate_shared<T>(alloc_type(), std::forward<Args>(args)...);
+}
+
+}  // namespace allocators
+
+/** N-d array with elements aligned to 64 bytes. */
+template <typename T, std::size_t N>
+using alignedArrayND =
+    boost::multi_array<T, N, allocators::AlignedAllocator<T, 64>>;
+
+/** N-d array with elements aligned to 64 bytes, and backed by huge pages if
+ * it is large enough. */
+template <typename T, std::size_t N>
+using hugePageArrayND =
+    boost::multi_array<T, N, allocators::AlignedAllocator<T, 64, true>>;
+
+/** N-d array with elements aligned to 64 bytes, that are first touched in
+ * parallel (see allocators::FirstTouchAllocator). */
+template <typename T, std::size_t N>
+using firstTouchArrayND =
+    boost::multi_array<T, N, allocators::FirstTouchAllocator<T, 64>>;
+
+/** N-d array allocated from the current arena (see allocators::Arena). */
+template <typename T, std::size_t N>
+using arenaArrayND = boost::multi_array<T, N, allocators::ArenaAllocator<T>>;
+
+/** 1-d array allocated from the current arena. Can be used for the axes of a
+ * coordinate system. */
+template <typename T>
+using arenaArray1D = boost::multi_array<T, 1, allocators::ArenaAllocator<T>>;
+
+#endif  // include protector
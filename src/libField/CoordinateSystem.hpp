@@ -4,13 +4,29 @@
 #include <boost/array.hpp>
 #include <boost/multi_array.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "Aliases.hpp"
+#include "Allocators.hpp"
 #include "RangeDiscretizers.hpp"
 #include "Utils.hpp"
 
+namespace detail {
+template <typename PA, typename PCS, size_t NDims>
+struct SliceState;
+}
+
 /** @file CoordinateSystem.hpp
  * @brief
  * @author C.D. Clark III
@@ -28,13 +44,156 @@ using view1D = boost::detail::multi_array::multi_array_view<T, 1>;
 template <typename COORD, size_t NUMDIMS,
           template <typename> class ARRAY = array1D>
 class CoordinateSystem {
+    template <typename, size_t, template <typename> class>
+    friend class CoordinateSystem;
+    template <typename, typename, size_t>
+    friend struct detail::SliceState;
+
    public:
     typedef ARRAY<COORD> axis_type;
     typedef typename axis_type::index coordinate_index_type;
     typedef CoordinateSystem<COORD, NUMDIMS, ARRAY> this_type;
 
+    /**
+     * Closed form index lookup for an axis that was set with a uniform or
+     * geometric range discretizer. The axis values are still stored, the
+     * lookup is only used to guess where a coordinate is, and the guess is
+     * checked against the stored values.
+     */
+    struct AxisLookup {
+        enum class Kind { None, Uniform, Geometric };
+        Kind kind = Kind::None;
+        COORD min{}, dx{};
+        double stretch = 1, log_stretch = 0;
+
+        /** Return the index of the last axis value <= c (approximately). May
+         * be out of range. */
+        double index(COORD c) const {
+            const double t = (c - min) / dx;
+            if (kind == Kind::Uniform) return std::floor(t);
+            // x_i = min + dx (s^i - 1) / (s - 1)
+            const double r = 1 + t * (stretch - 1);
+            return r > 0 ? std::floor(std::log(r) / log_stretch) : -1;
+        }
+    };
+
+    /** Tag used to construct a deep copy of a coordinate system (the copy
+     * constructor shares the axes). */
+    struct DeepCopy {};
+
+    /** Tag used to construct a coordinate system that refers to existing axes
+     * (instead of copying them). */
+    struct ShareAxes {};
+
+    /**
+     * Coarse index of an axis for searching nonuniform axes. The range of the
+     * axis is split into (about) one bucket per axis value, and the table
+     * stores the index of the first axis value in each bucket. A lookup
+     * computes the bucket of the coordinate in closed form, and only searches
+     * the axis values inside it, which is usually one or two values in the
+     * same cache line (instead of the log2(N) scattered reads of a binary
+     * search).
+     */
+    struct SearchIndex {
+        template <typename A>
+        explicit SearchIndex(const A& a) : n(a.size()), first(a.size() + 2) {
+            if (n > 1) {
+                min = a[0];
+                const double range = 1. * a[n - 1] - min;
+                if (range > 0 && std::isfinite(range)) scale = (n - 1) / range;
+            }
+            // the axis values are placed with the same function as the
+            // coordinates, so the search is exact even with round off.
+            size_t i = 0;
+            for (size_t j = 0; j < first.size(); ++j) {
+                while (i < n && bucket(a[i]) < j) ++i;
+                first[j] = i;
+            }
+        }
+
+        size_t size() const { return n; }
+
+        /** Return the bucket that c falls in. */
+        size_t bucket(COORD c) const {
+            double t = (1. * c - min) * scale;
+            if (!(t > 0)) return 0;
+            if (t > n) return n;
+            return static_cast<size_t>(t);
+        }
+
+        /** Return the range [begin, end) of axis indices in c's bucket. */
+        std::pair<size_t, size_t> range(COORD c) const {
+            const size_t j = bucket(c);
+            return {first[j], first[j + 1]};
+        }
+
+       protected:
+        size_t n;
+        double min = 0, scale = 0;
+        std::vector<uint32_t> first;
+    };
+
+    /**
+     * The SearchIndex of an axis, built by the first lookup after it was
+     * invalidated (i.e. the axis may have changed). Lookups can run in
+     * parallel, so the build is done under a lock and published with the
+     * dirty flag. Otherwise, a lookup only loads the flag and a raw pointer.
+     */
+    class LazySearchIndex {
+       public:
+        LazySearchIndex() = default;
+        LazySearchIndex(const LazySearchIndex& other) { *this = other; }
+        LazySearchIndex& operator=(const LazySearchIndex& other) {
+            if (this == &other) return *this;
+            // other may be building its index
+            std::lock_guard<std::mutex> lock(mutex());
+            index = other.index;
+            ptr = other.ptr;
+            dirty.store(other.dirty.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+            return *this;
+        }
+
+        /** Rebuild the index on the next lookup. Like any change to the
+         * axis, this must not race with lookups. */
+        void invalidate() { dirty.store(true, std::memory_order_relaxed); }
+
+        /** Return the index (or nullptr if the axis has none). If it is out
+         * of date, build() is called to make a new one first. */
+        template <typename B>
+        const SearchIndex* get(B build) const {
+            if (dirty.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(mutex());
+                if (dirty.load(std::memory_order_relaxed)) {
+                    index = build();
+                    ptr = index.get();
+                    dirty.store(false, std::memory_order_release);
+                }
+            }
+            return ptr;
+        }
+
+       protected:
+        static std::mutex& mutex() {
+            static std::mutex m;
+            return m;
+        }
+
+        // the index is read-only, so copies share it
+        mutable std::shared_ptr<const SearchIndex> index;
+        mutable const SearchIndex* ptr = nullptr;
+        mutable std::atomic<bool> dirty{true};
+    };
+
    protected:
     std::array<std::shared_ptr<axis_type>, NUMDIMS> axes;
+    std::array<AxisLookup, NUMDIMS> lookups;
+    bool use_search_index = false;
+    std::array<LazySearchIndex, NUMDIMS> search_indexes;
+    // the owner of the axes, if the axis pointers do not own them (i.e. the
+    // state of a field slice, see detail::SliceState). axis pointers handed
+    // out by the coordinate system, and its copies, share ownership with it.
+    std::weak_ptr<void> axes_owner;
 
    public:
 #if SERIALIZATION_ENABLED
@@ -42,16 +201,28 @@ class CoordinateSystem {
     template <class Archive>
     void serialize(Archive& ar, const unsigned int version) {
         ar& axes;
+        for (auto& i : search_indexes) i.invalidate();
     }
 
 #endif
 
     // make sure compiler generates all of the special member functions we need.
     CoordinateSystem() = default;
-    CoordinateSystem(const CoordinateSystem&) = default;
+    CoordinateSystem(const CoordinateSystem& other)
+        : axes(other.getAxes()),
+          lookups(other.lookups),
+          use_search_index(other.use_search_index),
+          search_indexes(other.search_indexes) {}
     CoordinateSystem(CoordinateSystem&&) = default;
     ~CoordinateSystem() = default;
-    CoordinateSystem& operator=(CoordinateSystem& rhs) = default;
+    CoordinateSystem& operator=(const CoordinateSystem& rhs) {
+        axes = rhs.getAxes();
+        lookups = rhs.lookups;
+        use_search_index = rhs.use_search_index;
+        search_indexes = rhs.search_indexes;
+        axes_owner.reset();
+        return *this;
+    }
     CoordinateSystem& operator=(CoordinateSystem&& rhs) = default;
 
     template <typename... Args>
@@ -62,17 +233,32 @@ class CoordinateSystem {
     template <typename I>
     CoordinateSystem(std::array<I, NUMDIMS> sizes) {
         for (size_t i = 0; i < NUMDIMS; i++)
-            axes[i] = std::make_shared<axis_type>(boost::extents[sizes[i]]);
+            axes[i] = allocators::allocate_shared_like<axis_type, axis_type>(
+                boost::extents[sizes[i]]);
     }
 
     CoordinateSystem(
         const std::array<std::shared_ptr<axis_type>, NUMDIMS>& axes_) {
         // we need to deep copy the axes, not just the shared pointer to them.
         for (size_t i = 0; i < NUMDIMS; i++) {
-            axes[i] = std::make_shared<axis_type>(*axes_[i]);
+            axes[i] = allocators::allocate_shared_like<axis_type, axis_type>(
+                *axes_[i]);
         }
     }
 
+    CoordinateSystem(
+        const std::array<std::shared_ptr<axis_type>, NUMDIMS>& axes_,
+        ShareAxes)
+        : axes(axes_) {}
+
+    CoordinateSystem(const CoordinateSystem& other, DeepCopy)
+        : CoordinateSystem(other.axes) {
+        lookups = other.lookups;
+        use_search_index = other.use_search_index;
+        // the indexes are read-only, so the copy can share them
+        search_indexes = other.search_indexes;
+    }
+
     /** Returns size of the i'th axis. */
     auto size(int i) const {
         if (i < 0) {
@@ -100,19 +286,62 @@ class CoordinateSystem {
 
     /** Return i'th axis */
     const auto& operator[](size_t i) const { return *axes[i]; }
-    auto& operator[](size_t i) { return *axes[i]; }
+    auto& operator[](size_t i) {
+        search_indexes[i].invalidate();
+        return *axes[i];
+    }
 
     /** Return i'th axis */
     const auto& getAxis(size_t i) const { return *axes[i]; }
-    auto& getAxis(size_t i) { return *axes[i]; }
+    auto& getAxis(size_t i) {
+        search_indexes[i].invalidate();
+        return *axes[i];
+    }
 
     /** Return pointer to i'th axis */
-    const auto getAxisPtr(size_t i) const { return axes[i]; }
-    auto getAxisPtr(size_t i) { return axes[i]; }
+    const auto getAxisPtr(size_t i) const { return owned_axis(i); }
+    auto getAxisPtr(size_t i) {
+        search_indexes[i].invalidate();
+        return owned_axis(i);
+    }
+
+    /** Return the closed form lookup used for the i'th axis. Its kind is
+     * None if the axis was not set with a Uniform or Geometric range. */
+    const AxisLookup& getAxisLookup(size_t i) const { return lookups[i]; }
+
+    /**
+     * Enable (or disable) searching axes with a SearchIndex.
+     *
+     * Index lookups (lower_bound, upper_bound, nearest, bracket) on axes that
+     * do not have a closed form lookup normally do a binary search of the
+     * axis. When enabled, a SearchIndex is built for each of these axes by
+     * the first lookup on it, and used instead. It takes an additional 4
+     * bytes per axis value, and is much faster for large axes. Axes must be
+     * sorted (as they must be for the binary search).
+     *
+     * The index is rebuilt by the next lookup after the axis may have been
+     * modified, i.e. after set() or a call to a non-const axis accessor
+     * (operator[], getAxis(), getAxisPtr(), getAxes()). Results are also
+     * checked against the axis values, so modifying an axis through a
+     * reference or pointer kept from before is still correct, but falls back
+     * to a binary search until the index is rebuilt.
+     */
+    void setSearchIndex(bool enable = true) {
+        use_search_index = enable;
+        for (auto& i : search_indexes) i.invalidate();
+    }
+    bool getSearchIndex() const { return use_search_index; }
 
     /** Return pointer to axes array */
-    const auto getAxes() const { return axes; }
-    auto getAxes() { return axes; }
+    const auto getAxes() const {
+        std::array<std::shared_ptr<axis_type>, NUMDIMS> r;
+        for (size_t i = 0; i < NUMDIMS; ++i) r[i] = owned_axis(i);
+        return r;
+    }
+    auto getAxes() {
+        for (auto& i : search_indexes) i.invalidate();
+        return static_cast<const CoordinateSystem&>(*this).getAxes();
+    }
 
     /** Return coordinate specified by indecies given as arguments */
     template <typename... Args>
@@ -167,14 +396,15 @@ class CoordinateSystem {
         for (size_t i = 0; i < NUMDIMS; i++) {
             // skip degenerate axes
             if (!ind.ranges_[i].degenerate_) {
-                new_axes[ii] = std::shared_ptr<view1D<COORD>>(
+                new_axes[ii] = std::make_shared<view1D<COORD>>(
                     axes[i]->operator[](indices[IRange(
                         ind.ranges_[i].start_, ind.ranges_[i].finish_,
                         ind.ranges_[i].stride_)]));
                 ii++;
             }
         }
-        return CoordinateSystem<COORD, NDims, view1D>(new_axes);
+        typedef CoordinateSystem<COORD, NDims, view1D> R;
+        return R(new_axes, typename R::ShareAxes());
     }
 
     /** Return a sliced coordinate system view based on an index generator. */
@@ -201,7 +431,69 @@ class CoordinateSystem {
                 ii++;
             }
         }
-        return CoordinateSystem<COORD, NDims, view1D>(new_axes);
+        typedef CoordinateSystem<COORD, NDims, view1D> R;
+        return R(new_axes, typename R::ShareAxes());
+    }
+
+    /**
+     * Return a view of the axis that is the k'th axis of the slice made by
+     * an index generator (i.e. the k'th non-degenerate range).
+     */
+    template <int NDims>
+    view1D<COORD> slice_axis(
+        const boost::detail::multi_array::index_gen<NUMDIMS, NDims>& ind,
+        size_t k) const {
+        BOOST_ASSERT(k < static_cast<size_t>(NDims));
+        boost::multi_array_types::index_gen indices;
+        size_t i = 0;
+        for (size_t ii = 0;; ++i)
+            if (!ind.ranges_[i].degenerate_ && ii++ == k) break;
+        return axes[i]->operator[](
+            indices[IRange(ind.ranges_[i].start_, ind.ranges_[i].finish_,
+                           ind.ranges_[i].stride_)]);
+    }
+
+    /**
+     * Return a coordinate system with the axes of this one, except the k'th.
+     * The axes are copied, into the same kind of array (or into array1D axes
+     * if these are views), and keep their closed form lookups.
+     */
+    auto drop_axis(size_t k) const {
+        typedef typename std::conditional<
+            IsOwningArray1D<ARRAY, COORD>::value,
+            CoordinateSystem<COORD, NUMDIMS - 1, ARRAY>,
+            CoordinateSystem<COORD, NUMDIMS - 1>>::type R;
+        return drop_axis<R>(k);
+    }
+
+    /**
+     * Return a coordinate system of type R (with NUMDIMS-1 dimensions) with
+     * copies of the axes of this one, except the k'th.
+     */
+    template <typename R>
+    R drop_axis(size_t k) const {
+        BOOST_STATIC_ASSERT_MSG(NUMDIMS > 1,
+                                "CoordinateSystem<COORD,NUMDIMS> "
+                                "drop_axis called on a 1D coordinate system.");
+        BOOST_ASSERT(k < NUMDIMS);
+        R r;
+        for (size_t i = 0, j = 0; i < NUMDIMS; ++i) {
+            if (i == k) continue;
+            const auto& a = *axes[i];
+            r.axes[j] = allocators::allocate_shared_like<
+                typename R::axis_type, typename R::axis_type>(
+                boost::extents[a.size()]);
+            std::copy(a.begin(), a.end(), r.axes[j]->begin());
+            auto& l = r.lookups[j];
+            l.kind = static_cast<typename R::AxisLookup::Kind>(lookups[i].kind);
+            l.min = lookups[i].min;
+            l.dx = lookups[i].dx;
+            l.stretch = lookups[i].stretch;
+            l.log_stretch = lookups[i].log_stretch;
+            ++j;
+        }
+        r.use_search_index = use_search_index;
+        return r;
     }
 
     /** WARNING: this does not have the same meaning as std::lower_bound.*/
@@ -226,12 +518,331 @@ class CoordinateSystem {
         return ind;
     }
 
+    /**
+     * Return the index i of the interval [x_i, x_{i+1}] along the k'th axis
+     * that contains the coordinate c. The index is clamped to the first and
+     * last intervals, so coordinates outside of the axis are bracketed by the
+     * nearest interval.
+     *
+     * If hint is a valid interval index (i.e. the result of a previous call
+     * for a nearby coordinate), the interval at hint and its neighbors are
+     * checked before searching the axis.
+     */
+    int bracket(size_t k, COORD c, int hint = -1) const {
+        const auto& a = *axes[k];
+        const int n = a.size();
+        if (n < 2) return 0;
+        if (hint >= 0 && hint < n - 1) {
+            if (!(c < a[hint])) {
+                if (hint == n - 2 || c < a[hint + 1]) return hint;
+                if (hint == n - 3 || c < a[hint + 2]) return hint + 1;
+            } else if (hint == 0 || !(c < a[hint - 1])) {
+                return std::max(hint - 1, 0);
+            }
+        }
+        int i = static_cast<int>(upper_bound_index(k, c)) - 1;
+        return std::min(std::max(i, 0), n - 2);
+    }
+
+    /**
+     * Batched lookups along the k'th axis: ind[i] is set to the index that
+     * lower_bound (upper_bound, nearest) would return along the k'th axis for
+     * coords[i].
+     *
+     * Queries are processed in PARALLEL, in contiguous chunks. Within a chunk,
+     * the search for each query starts from the result for the previous one
+     * and gallops (1, 2, 4, ... values) toward the new coordinate, so sorted
+     * or nearly sorted queries cost O(log d) comparisons each, where d is the
+     * number of axis values between consecutive queries. Unsorted queries
+     * still give correct results.
+     */
+    void lower_bound_batched(size_t k, Span<const COORD> coords,
+                             Span<int> ind) const {
+        batched_imp(k, coords, ind,
+                    [](COORD, size_t u) { return static_cast<int>(u) - 1; });
+    }
+    void upper_bound_batched(size_t k, Span<const COORD> coords,
+                             Span<int> ind) const {
+        batched_imp(k, coords, ind,
+                    [](COORD, size_t u) { return static_cast<int>(u); });
+    }
+    void nearest_batched(size_t k, Span<const COORD> coords,
+                         Span<int> ind) const {
+        batched_imp(k, coords, ind, [this, k](COORD c, size_t u) {
+            return nearest_index(k, c, u);
+        });
+    }
+
+    /** Batched lookups that return a vector of indices. */
+    std::vector<int> lower_bound_batched(size_t k,
+                                         Span<const COORD> coords) const {
+        std::vector<int> ind(coords.size());
+        lower_bound_batched(k, coords, ind);
+        return ind;
+    }
+    std::vector<int> upper_bound_batched(size_t k,
+                                         Span<const COORD> coords) const {
+        std::vector<int> ind(coords.size());
+        upper_bound_batched(k, coords, ind);
+        return ind;
+    }
+    std::vector<int> nearest_batched(size_t k,
+                                     Span<const COORD> coords) const {
+        std::vector<int> ind(coords.size());
+        nearest_batched(k, coords, ind);
+        return ind;
+    }
+
+    /**
+     * A lookup cursor that remembers the result of its last lookup along each
+     * axis, and "hunts" for the next one starting from there (see
+     * gallop_upper_bound()). A coordinate in the same or a neighboring cell
+     * is found with two or three comparisons, and one that has moved d cells
+     * with O(log d). The first lookup along an axis is a normal search.
+     *
+     * A cursor holds a pointer to its coordinate system, so it must not
+     * outlive it, and it is not thread safe. Use one cursor per particle (or
+     * per thread).
+     *
+     * @code
+     * auto cur = cs.cursor();
+     * for (auto x : track) {
+     *     auto ind = cur.lower_bound(x[0], x[1]);
+     *     ...
+     * }
+     * @endcode
+     */
+    class Cursor {
+       public:
+        explicit Cursor(const CoordinateSystem& cs) : cs(&cs) { reset(); }
+
+        /** Forget the previous lookups. */
+        void reset() { u.fill(size_t(none)); }
+
+        /** Same as CoordinateSystem::lower_bound(). */
+        template <typename... Args>
+        std::array<int, NUMDIMS> lower_bound(Args... args) {
+            auto ind = upper_bound(args...);
+            for (auto& i : ind) --i;
+            return ind;
+        }
+
+        /** Same as CoordinateSystem::upper_bound(). */
+        template <typename... Args>
+        std::array<int, NUMDIMS> upper_bound(Args... args) {
+            BOOST_STATIC_ASSERT_MSG(sizeof...(Args) == NUMDIMS,
+                                    "CoordinateSystem<COORD,NUMDIMS>::Cursor "
+                                    "called with wrong number of arguments.");
+            const std::array<COORD, NUMDIMS> x{{static_cast<COORD>(args)...}};
+            std::array<int, NUMDIMS> ind;
+            for (size_t k = 0; k < NUMDIMS; ++k)
+                ind[k] = static_cast<int>(hunt(k, x[k]));
+            return ind;
+        }
+
+        /** Same as CoordinateSystem::nearest(). */
+        template <typename... Args>
+        std::array<int, NUMDIMS> nearest(Args... args) {
+            BOOST_STATIC_ASSERT_MSG(sizeof...(Args) == NUMDIMS,
+                                    "CoordinateSystem<COORD,NUMDIMS>::Cursor "
+                                    "called with wrong number of arguments.");
+            const std::array<COORD, NUMDIMS> x{{static_cast<COORD>(args)...}};
+            std::array<int, NUMDIMS> ind;
+            for (size_t k = 0; k < NUMDIMS; ++k)
+                ind[k] = cs->nearest_index(k, x[k], hunt(k, x[k]));
+            return ind;
+        }
+
+        /** Same as CoordinateSystem::bracket(). */
+        int bracket(size_t k, COORD c) {
+            const int n = cs->size(k);
+            if (n < 2) return 0;
+            const int i = static_cast<int>(hunt(k, c)) - 1;
+            return std::min(std::max(i, 0), n - 2);
+        }
+
+        /** Return the upper_bound_index of c on the k'th axis. */
+        size_t hunt(size_t k, COORD c) {
+            u[k] = u[k] == none ? cs->upper_bound_index(k, c)
+                                : cs->gallop_upper_bound(k, c, u[k]);
+            return u[k];
+        }
+
+       protected:
+        static constexpr size_t none = std::numeric_limits<size_t>::max();
+        const CoordinateSystem* cs;
+        std::array<size_t, NUMDIMS> u;
+    };
+
+    /** Return a lookup cursor for this coordinate system (see Cursor). */
+    Cursor cursor() const { return Cursor(*this); }
+
     // helper functions/implementations
    protected:
+    /** Return a pointer to the i'th axis that owns it (see axes_owner). */
+    std::shared_ptr<axis_type> owned_axis(size_t i) const {
+        auto owner = axes_owner.lock();
+        if (!owner) return axes[i];
+        return std::shared_ptr<axis_type>(owner, axes[i].get());
+    }
+
+    /**
+     * Return the number of values on the k'th axis that are <= c (the index
+     * returned by std::upper_bound).
+     *
+     * If the axis has a closed form lookup, its guess and the indices next to
+     * it are checked against the stored values, so the result is correct even
+     * if the axis was modified after it was set. Otherwise (or if the guess is
+     * wrong), the axis is searched.
+     */
+    size_t upper_bound_index(size_t k, COORD c) const {
+        const auto& a = *axes[k];
+        const size_t n = a.size();
+        if (lookups[k].kind != AxisLookup::Kind::None && n > 1) {
+            double g = lookups[k].index(c) + 1;
+            if (!(g > 0)) g = 0;
+            if (g > n) g = n;
+            const size_t u = g;
+            for (size_t v : {u, u + 1, u - 1}) {
+                if (is_upper_bound(a, c, v)) return v;
+            }
+        } else if (const SearchIndex* index = search_indexes[k].get(
+                       [&] { return make_search_index(k); })) {
+            // the index is only read here, so it is shared between threads.
+            // if the axis has changed since it was built, the result does not
+            // check out, and the axis is searched. (c == c skips NaN.)
+            if (index->size() == n && c == c) {
+                const auto r = index->range(c);
+                const size_t v = std::upper_bound(a.begin() + r.first,
+                                                  a.begin() + r.second, c) -
+                                 a.begin();
+                if (is_upper_bound(a, c, v)) return v;
+            }
+        }
+        return std::upper_bound(a.begin(), a.end(), c) - a.begin();
+    }
+
+    /**
+     * Return the upper_bound_index of c on the k'th axis, starting from the
+     * index u (i.e. the result for a previous, nearby coordinate). The search
+     * gallops away from u in steps of 1, 2, 4, ... values until c is
+     * bracketed, and then does a binary search of the last step.
+     */
+    size_t gallop_upper_bound(size_t k, COORD c, size_t u) const {
+        const auto& a = *axes[k];
+        const size_t n = a.size();
+        if (u > n) u = n;
+        // the result is in [lo, hi]
+        size_t lo, hi;
+        if (u < n && !(c < a[u])) {
+            lo = u + 1;
+            hi = lo;
+            for (size_t step = 1; hi < n && !(c < a[hi]); step *= 2) {
+                lo = hi + 1;
+                hi += step;
+            }
+            hi = std::min(hi, n);
+        } else if (u > 0 && c < a[u - 1]) {
+            hi = u - 1;
+            lo = hi;
+            for (size_t step = 1; lo > 0 && c < a[lo - 1]; step *= 2) {
+                hi = lo - 1;
+                lo = lo > step ? lo - step : 0;
+            }
+        } else {
+            return u;
+        }
+        return std::upper_bound(a.begin() + lo, a.begin() + hi, c) -
+               a.begin();
+    }
+
+    /** Return the index of the value on the k'th axis that is closest to c,
+     * given u = upper_bound_index(k, c). */
+    int nearest_index(size_t k, COORD c, size_t u) const {
+        const auto& a = *axes[k];
+        const size_t n = a.size();
+        // coordinate is less than smallest, or not less than largest
+        if (u == 0) return 0;
+        if (u >= n) return static_cast<int>(n) - 1;
+        // get index of element that is just below coordinate
+        int i = static_cast<int>(u) - 1;
+        // now determine if coordinate is closer to the upper bound or lower
+        // bound coord - lower bound divided by upper bound minus lower
+        // bound gives the dimensionless coordinate between 0 and 1. if this
+        // is less than 0.5, we want to return the lower bound index. if
+        // itis greater than 0.5, we want to return the upper bound index
+        i += 2 * (c - a[i]) / (a[i + 1] - a[i]);
+        return i;
+    }
+
+    template <typename OP>
+    void batched_imp(size_t k, Span<const COORD> coords, Span<int> ind,
+                     OP op) const {
+        BOOST_ASSERT(ind.size() == coords.size());
+        detail::for_each_block(coords.size(), [&](size_t b, size_t e) {
+            size_t u = upper_bound_index(k, coords[b]);
+            for (size_t i = b; i < e; ++i) {
+                u = gallop_upper_bound(k, coords[i], u);
+                ind[i] = op(coords[i], u);
+            }
+        });
+    }
+
+    /** Return true if v is the std::upper_bound index of c on axis a. */
+    template <typename A>
+    static bool is_upper_bound(const A& a, COORD c, size_t v) {
+        const size_t n = a.size();
+        return v <= n && (v == 0 || !(c < a[v - 1])) && (v == n || c < a[v]);
+    }
+
+    template <typename R>
+    static AxisLookup make_lookup(const R&, size_t) {
+        return AxisLookup();
+    }
+
+    template <typename T>
+    static AxisLookup make_lookup(const range_discretizers::UniformImp<T>& r,
+                                  size_t N) {
+        AxisLookup l;
+        if (N < 2 || !(r.getMin() < r.getMax())) return l;
+        l.kind = AxisLookup::Kind::Uniform;
+        l.min = r.getMin();
+        l.dx = (1. * r.getMax() - 1. * r.getMin()) / (N - 1);
+        return l;
+    }
+
+    template <typename T>
+    static AxisLookup make_lookup(
+        const range_discretizers::GeometricImp<T>& r, size_t N) {
+        AxisLookup l;
+        if (N < 2 || !(r.getDx() > T()) || !(r.getStretch() > 1)) return l;
+        l.kind = AxisLookup::Kind::Geometric;
+        l.min = r.getMin();
+        l.dx = r.getDx();
+        l.stretch = r.getStretch();
+        l.log_stretch = std::log(l.stretch);
+        return l;
+    }
+
+    /**
+     * Build the SearchIndex of the k'th axis. Returns nullptr if search
+     * indexes are disabled or the axis has a closed form lookup.
+     */
+    std::shared_ptr<const SearchIndex> make_search_index(size_t k) const {
+        if (!use_search_index || !axes[k] ||
+            lookups[k].kind != AxisLookup::Kind::None)
+            return nullptr;
+        const size_t n = axes[k]->size();
+        if (n > 1 && n < std::numeric_limits<uint32_t>::max())
+            return std::make_shared<const SearchIndex>(*axes[k]);
+        return nullptr;
+    }
+
     template <int II, typename N, typename... Args>
     typename std::enable_if<std::is_integral<N>::value, void>::type init_imp(
         N n, Args... args) {
-        axes[II] = std::make_shared<axis_type>(boost::extents[n]);
+        axes[II] = allocators::allocate_shared_like<axis_type, axis_type>(
+            boost::extents[n]);
         init_imp<II + 1>(args...);
     }
 
@@ -254,6 +865,8 @@ class CoordinateSystem {
     set_imp(R range, Args... args) {
         size_t N = axes[II]->size();
         for (size_t i = 0; i < N; ++i) axes[II]->operator[](i) = range(i, N);
+        lookups[II] = make_lookup(range, N);
+        search_indexes[II].invalidate();
 
         set_imp<II + 1>(args...);
     }
@@ -288,8 +901,7 @@ class CoordinateSystem {
 
     template <int II, typename IND, typename C, typename... Args>
     void lower_bound_imp(IND& ind, C c, Args... args) const {
-        ind[II] = std::upper_bound(axes[II]->begin(), axes[II]->end(), c) -
-                  axes[II]->begin() - 1;
+        ind[II] = static_cast<int>(upper_bound_index(II, c)) - 1;
         lower_bound_imp<II + 1>(ind, args...);
     }
 
@@ -303,8 +915,7 @@ class CoordinateSystem {
 
     template <int II, typename IND, typename C, typename... Args>
     void upper_bound_imp(IND& ind, C c, Args... args) const {
-        ind[II] = std::upper_bound(axes[II]->begin(), axes[II]->end(), c) -
-                  axes[II]->begin();
+        ind[II] = upper_bound_index(II, c);
         upper_bound_imp<II + 1>(ind, args...);
     }
 
@@ -318,29 +929,7 @@ class CoordinateSystem {
 
     template <int II, typename IND, typename C, typename... Args>
     void nearest_imp(IND& ind, C c, Args... args) const {
-        // special cases:
-        // coordinate is less than smallest
-        if (c < axes[II]->operator[](0)) {
-            ind[II] = 0;
-        }
-        // coordinate is greater than largest
-        else if (c > axes[II]->operator[](axes[II]->size() - 1)) {
-            ind[II] = axes[II]->size() - 1;
-        } else {
-            // get index of element that is just below coordinate
-            ind[II] = std::upper_bound(axes[II]->begin(), axes[II]->end(), c) -
-                      axes[II]->begin() - 1;
-            // now determine if coordinate is closer to the upper bound or lower
-            // bound coord - lower bound divided by upper bound minus lower
-            // bound gives the dimensionless coordinate between 0 and 1. if this
-            // is less than 0.5, we want to return the lower bound index. if
-            // itis greater than 0.5, we want to return the upper bound index
-            // don't have to worry about special cases above here.
-            ind[II] += 2 * (c - axes[II]->operator[](ind[II])) /
-                       (axes[II]->operator[](ind[II] + 1) -
-                        axes[II]->operator[](ind[II]));
-        }
-
+        ind[II] = nearest_index(II, c, upper_bound_index(II, c));
         nearest_imp<II + 1>(ind, args...);
     }
 
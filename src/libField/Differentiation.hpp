@@ -0,0 +1,324 @@
+#ifndef Differentiation_hpp
+#define Differentiation_hpp
+
+/** @file Differentiation.hpp
+ * @brief Finite difference derivatives, gradients, divergences, and
+ * Laplacians of fields.
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * Derivatives are computed with three point stencils built from the stored
+ * coordinates, so nonuniform axes are handled correctly (second order
+ * accurate first derivatives, and first order accurate second derivatives on
+ * nonuniform axes). The result is written to an output field, which is
+ * allocated with a copy of the input if it does not have the same number of
+ * elements.
+ *
+ * @code
+ * Field<double,3> T(100,100,100), L;
+ * ...
+ * laplacian(T, L);
+ * std::array<Field<double,3>,3> grad;
+ * gradient(T, grad, Boundary::Periodic);
+ * @endcode
+ *
+ * The fields must store their elements contiguously (i.e. they cannot be
+ * slices). The field is traversed row by row (along the last axis), in
+ * parallel, in tiles that are small enough for the rows needed by the
+ * stencils of a tile to stay in the L2 cache.
+ */
+
+#include <algorithm>
+#include <array>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "Utils.hpp"
+
+/**
+ * How derivatives are computed at the first and last elements along an axis.
+ *
+ * OneSided: use the first (last) three elements along the axis.
+ *
+ * Periodic: the axis wraps around. The spacing between the last and first
+ * elements is taken to be the average spacing of the axis, so an axis of N
+ * uniformly spaced points covers N intervals of one period.
+ *
+ * Zero: the derivative along the axis is zero at the boundary elements.
+ */
+enum class Boundary { OneSided, Periodic, Zero };
+
+namespace detail {
+/**
+ * Three point finite difference stencil for one element along an axis. The
+ * derivative is sum_m w[m] * f[i + offset[m]].
+ */
+struct Stencil3 {
+    std::array<std::ptrdiff_t, 3> offset{{0, 0, 0}};
+    std::array<double, 3> w{{0, 0, 0}};
+};
+
+/**
+ * Build the stencils for the first (order = 1) or second (order = 2)
+ * derivative at each point of axis x. The weights are those of the derivative
+ * of the quadratic through the three points.
+ */
+template <typename A>
+std::vector<Stencil3> make_stencils(const A& x, int order, Boundary bc) {
+    const std::ptrdiff_t n = x.size();
+    std::vector<Stencil3> s(n);
+    if (n < 2) return s;
+    if (n == 2 && bc != Boundary::Periodic) {
+        // only a straight line fits through two points
+        if (order == 1 && bc == Boundary::OneSided) {
+            const double h = x[1] - x[0];
+            for (std::ptrdiff_t i = 0; i < 2; ++i) {
+                s[i].offset = {{-i, 1 - i, 0}};
+                s[i].w = {{-1 / h, 1 / h, 0}};
+            }
+        }
+        return s;
+    }
+
+    const double period = (1. * x[n - 1] - x[0]) * n / (n - 1);
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        // the three points, and their coordinates
+        std::array<std::ptrdiff_t, 3> j{{i - 1, i, i + 1}};
+        std::array<double, 3> c;
+        if (i == 0 || i == n - 1) {
+            if (bc == Boundary::Zero) continue;
+            if (bc == Boundary::OneSided) {
+                const std::ptrdiff_t f = i == 0 ? 0 : n - 3;
+                j = {{f, f + 1, f + 2}};
+            }
+        }
+        for (size_t m = 0; m < 3; ++m) {
+            if (j[m] < 0) {
+                j[m] += n;
+                c[m] = x[j[m]] - period;
+            } else if (j[m] >= n) {
+                j[m] -= n;
+                c[m] = x[j[m]] + period;
+            } else {
+                c[m] = x[j[m]];
+            }
+        }
+
+        const double xi = x[i];
+        for (size_t m = 0; m < 3; ++m) {
+            const double a = c[(m + 1) % 3], b = c[(m + 2) % 3];
+            const double d = (c[m] - a) * (c[m] - b);
+            s[i].offset[m] = j[m] - i;
+            s[i].w[m] = order == 1 ? ((xi - a) + (xi - b)) / d : 2 / d;
+        }
+    }
+    return s;
+}
+
+/**
+ * One term of a finite difference operator: the derivative of the input
+ * along an axis, with the given stencils, added to an output.
+ */
+template <typename Q>
+struct DifferenceTerm {
+    const Q* in;
+    size_t axis;
+    const std::vector<Stencil3>* stencils;
+    size_t out;
+};
+
+/**
+ * Evaluate the terms for every element of arrays with the given shape
+ * (row-major, contiguous), writing out[t.out] = sum of its terms.
+ *
+ * Rows (along the last axis) are processed in the cache sized tiles of
+ * for_each_row(), so that the rows read by the stencils of neighbouring rows
+ * are reused from cache.
+ */
+template <typename Q, size_t N>
+void apply_difference_terms(const std::array<size_t, N>& shape,
+                            const std::vector<DifferenceTerm<Q>>& terms,
+                            const std::vector<Q*>& out) {
+    std::array<size_t, N> stride;
+    stride[N - 1] = 1;
+    for (size_t k = N - 1; k-- > 0;) stride[k] = stride[k + 1] * shape[k + 1];
+
+    size_t inputs = 0;
+    for (size_t t = 0; t < terms.size(); ++t)
+        if (t == 0 || terms[t].in != terms[t - 1].in) ++inputs;
+    // the first term for each output sets it, the others add to it
+    std::vector<bool> first(terms.size());
+    for (size_t t = 0; t < terms.size(); ++t) {
+        first[t] = true;
+        for (size_t u = 0; u < t; ++u)
+            if (terms[u].out == terms[t].out) first[t] = false;
+    }
+
+    const size_t row_bytes = shape[N - 1] * sizeof(Q) * inputs;
+    for_each_row(shape, 1, row_bytes, [&](const std::array<size_t, N>& ind,
+                                          size_t l0, size_t l1) {
+        size_t base = 0;
+        for (size_t k = 0; k < N; ++k) base += ind[k] * stride[k];
+
+        for (size_t it = 0; it < terms.size(); ++it) {
+            const auto& t = terms[it];
+            Q* y = out[t.out] + base;
+            const Q* x = t.in + base;
+            const bool set = first[it];
+            if (t.axis == N - 1) {
+                const Stencil3* s = t.stencils->data();
+                for (size_t l = l0; l < l1; ++l) {
+                    const auto& sl = s[l];
+                    const Q* xl = x + l;
+                    const Q v = sl.w[0] * xl[sl.offset[0]] +
+                                sl.w[1] * xl[sl.offset[1]] +
+                                sl.w[2] * xl[sl.offset[2]];
+                    y[l] = set ? v : y[l] + v;
+                }
+            } else {
+                const auto& s = (*t.stencils)[ind[t.axis]];
+                const std::ptrdiff_t st = stride[t.axis];
+                const Q* x0 = x + s.offset[0] * st;
+                const Q* x1 = x + s.offset[1] * st;
+                const Q* x2 = x + s.offset[2] * st;
+                const double w0 = s.w[0], w1 = s.w[1], w2 = s.w[2];
+                if (set) {
+                    for (size_t l = l0; l < l1; ++l)
+                        y[l] = w0 * x0[l] + w1 * x1[l] + w2 * x2[l];
+                } else {
+                    for (size_t l = l0; l < l1; ++l)
+                        y[l] += w0 * x0[l] + w1 * x1[l] + w2 * x2[l];
+                }
+            }
+        }
+    });
+}
+
+template <typename F>
+auto difference_shape(const F& f) {
+    std::array<size_t, F::array_type::dimensionality> shape;
+    for (size_t k = 0; k < shape.size(); ++k) shape[k] = f.size(k);
+    return shape;
+}
+
+/**
+ * Allocate out with a copy of f if it does not have the same shape, and
+ * return a pointer to its elements.
+ */
+template <typename F>
+auto difference_output(const F& f, F& out) {
+    BOOST_ASSERT(&f != &out);
+    if (!out.getDataPtr() || difference_shape(out) != difference_shape(f))
+        out = f;
+    auto p = contiguous_data(out.getData());
+    BOOST_ASSERT(p != nullptr);
+    return p;
+}
+
+template <typename F>
+auto difference_input(const F& f) {
+    auto p = contiguous_data(f.getData());
+    BOOST_ASSERT(p != nullptr);
+    return p;
+}
+}  // namespace detail
+
+/**
+ * @brief Compute the first derivative of field f along its k'th axis.
+ *
+ * @param f the field to differentiate.
+ * @param k the axis.
+ * @param out the field to write the derivative to.
+ * @param bc the boundary treatment (see Boundary).
+ */
+template <typename F>
+void derivative(const F& f, size_t k, F& out,
+                Boundary bc = Boundary::OneSided) {
+    typedef typename F::array_type::element Q;
+    const auto st = detail::make_stencils(f.getAxis(k), 1, bc);
+    const std::vector<detail::DifferenceTerm<Q>> terms{
+        {detail::difference_input(f), k, &st, 0}};
+    detail::apply_difference_terms(detail::difference_shape(f), terms,
+                                   {detail::difference_output(f, out)});
+}
+
+/**
+ * @brief Compute the second derivative of field f along its k'th axis (see
+ * derivative()).
+ */
+template <typename F>
+void second_derivative(const F& f, size_t k, F& out,
+                       Boundary bc = Boundary::OneSided) {
+    typedef typename F::array_type::element Q;
+    const auto st = detail::make_stencils(f.getAxis(k), 2, bc);
+    const std::vector<detail::DifferenceTerm<Q>> terms{
+        {detail::difference_input(f), k, &st, 0}};
+    detail::apply_difference_terms(detail::difference_shape(f), terms,
+                                   {detail::difference_output(f, out)});
+}
+
+/**
+ * @brief Compute the Laplacian (the sum of the second derivatives along each
+ * axis) of field f, in a single pass over the field.
+ */
+template <typename F>
+void laplacian(const F& f, F& out, Boundary bc = Boundary::OneSided) {
+    typedef typename F::array_type::element Q;
+    const size_t N = F::array_type::dimensionality;
+    std::vector<std::vector<detail::Stencil3>> st(N);
+    std::vector<detail::DifferenceTerm<Q>> terms(N);
+    for (size_t k = 0; k < N; ++k) {
+        st[k] = detail::make_stencils(f.getAxis(k), 2, bc);
+        terms[k] = {detail::difference_input(f), k, &st[k], 0};
+    }
+    detail::apply_difference_terms(detail::difference_shape(f), terms,
+                                   {detail::difference_output(f, out)});
+}
+
+/**
+ * @brief Compute the gradient of field f, in a single pass over the field.
+ * grad[k] is set to the derivative along the k'th axis.
+ */
+template <typename F, size_t N>
+void gradient(const F& f, std::array<F, N>& grad,
+              Boundary bc = Boundary::OneSided) {
+    static_assert(N == F::array_type::dimensionality,
+                  "gradient needs one output field per dimension.");
+    typedef typename F::array_type::element Q;
+    std::vector<std::vector<detail::Stencil3>> st(N);
+    std::vector<detail::DifferenceTerm<Q>> terms(N);
+    std::vector<Q*> out(N);
+    for (size_t k = 0; k < N; ++k) {
+        st[k] = detail::make_stencils(f.getAxis(k), 1, bc);
+        terms[k] = {detail::difference_input(f), k, &st[k], k};
+        out[k] = detail::difference_output(f, grad[k]);
+    }
+    detail::apply_difference_terms(detail::difference_shape(f), terms, out);
+}
+
+/**
+ * @brief Compute the divergence of the vector field v (the sum of the
+ * derivatives of v[k] along the k'th axis), in a single pass over the
+ * fields. The components must have the same shape and coordinates.
+ */
+template <typename F, size_t N>
+void divergence(const std::array<F, N>& v, F& out,
+                Boundary bc = Boundary::OneSided) {
+    static_assert(N == F::array_type::dimensionality,
+                  "divergence needs one input field per dimension.");
+    typedef typename F::array_type::element Q;
+    std::vector<std::vector<detail::Stencil3>> st(N);
+    std::vector<detail::DifferenceTerm<Q>> terms(N);
+    for (size_t k = 0; k < N; ++k) {
+        BOOST_ASSERT(detail::difference_shape(v[k]) ==
+                     detail::difference_shape(v[0]));
+        BOOST_ASSERT(&v[k] != &out);
+        st[k] = detail::make_stencils(v[0].getAxis(k), 1, bc);
+        terms[k] = {detail::difference_input(v[k]), k, &st[k], 0};
+    }
+    detail::apply_difference_terms(detail::difference_shape(v[0]), terms,
+                                   {detail::difference_output(v[0], out)});
+}
+
+#endif  // include protector
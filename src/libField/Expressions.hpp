@@ -0,0 +1,352 @@
+#ifndef Expressions_hpp
+#define Expressions_hpp
+
+/** @file Expressions.hpp
+ * @brief Lazily evaluated arithmetic expressions of fields.
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * Arithmetic operators applied to fields (and scalars) do not compute
+ * anything. They build an expression object that records the operation, and
+ * the expression is evaluated element-by-element, in a single parallel pass,
+ * when it is assigned to a field.
+ *
+ * @code
+ * Field<double,3> T(100,100,100), B(T), C(T), D(T);
+ * ...
+ * T = 2*B + C/D;  // one pass over memory, no temporary fields
+ * T += exp(-B);
+ * @endcode
+ *
+ * Expressions keep references to the fields they are built from, so they
+ * should be assigned in the same statement that creates them. Storing an
+ * expression built from a temporary field (with auto for example) will leave a
+ * dangling reference.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "Utils.hpp"
+
+namespace field_expressions {
+
+/**
+ * Leaf node that refers to the elements of a field.
+ */
+template <typename F>
+class FieldRef {
+   public:
+    static constexpr bool has_field = true;
+
+    FieldRef(const F& f) : f(f), p(detail::contiguous_data(f.getData())) {}
+
+    /** Return the element with the given 1d (row-major) index. Only valid if
+     * is_contiguous() is true. */
+    const auto& operator[](size_t i) const { return p[i]; }
+
+    /** Return the element with the given Nd index. */
+    template <typename I>
+    const auto& operator()(const I& ind) const {
+        return f(ind);
+    }
+
+    bool is_contiguous() const { return p != nullptr; }
+
+    bool has_shape(const size_t* shape, size_t n) const {
+        if (f.getData().num_dimensions() != n) return false;
+        for (size_t i = 0; i < n; ++i)
+            if (f.size(i) != shape[i]) return false;
+        return true;
+    }
+
+    const auto& getCoordinateSystem() const { return f.getCoordinateSystem(); }
+
+   protected:
+    const F& f;
+    decltype(detail::contiguous_data(std::declval<const F&>().getData())) p;
+};
+
+/**
+ * Leaf node that holds a scalar value. The value is broadcast to every
+ * element.
+ */
+template <typename T>
+class Scalar {
+   public:
+    static constexpr bool has_field = false;
+
+    Scalar(const T& v) : v(v) {}
+
+    const T& operator[](size_t) const { return v; }
+
+    template <typename I>
+    const T& operator()(const I&) const {
+        return v;
+    }
+
+    bool is_contiguous() const { return true; }
+    bool has_shape(const size_t*, size_t) const { return true; }
+
+   protected:
+    T v;
+};
+
+/**
+ * Node that applies the binary operation OP to the elements of two
+ * expressions.
+ */
+template <typename OP, typename L, typename R>
+class BinaryExpression {
+   public:
+    static constexpr bool has_field = L::has_field || R::has_field;
+
+    BinaryExpression(const L& l, const R& r) : l(l), r(r) {}
+
+    auto operator[](size_t i) const { return OP::apply(l[i], r[i]); }
+
+    template <typename I>
+    auto operator()(const I& ind) const {
+        return OP::apply(l(ind), r(ind));
+    }
+
+    bool is_contiguous() const {
+        return l.is_contiguous() && r.is_contiguous();
+    }
+
+    bool has_shape(const size_t* shape, size_t n) const {
+        return l.has_shape(shape, n) && r.has_shape(shape, n);
+    }
+
+    /** Return the coordinate system of the left-most field in the
+     * expression. */
+    const auto& getCoordinateSystem() const {
+        return getCoordinateSystem_imp(
+            std::integral_constant<bool, L::has_field>());
+    }
+
+   protected:
+    L l;
+    R r;
+
+    const auto& getCoordinateSystem_imp(std::true_type) const {
+        return l.getCoordinateSystem();
+    }
+    const auto& getCoordinateSystem_imp(std::false_type) const {
+        return r.getCoordinateSystem();
+    }
+};
+
+/**
+ * Node that applies the unary operation OP to the elements of an expression.
+ */
+template <typename OP, typename E>
+class UnaryExpression {
+   public:
+    static constexpr bool has_field = E::has_field;
+
+    UnaryExpression(const E& e) : e(e) {}
+
+    auto operator[](size_t i) const { return OP::apply(e[i]); }
+
+    template <typename I>
+    auto operator()(const I& ind) const {
+        return OP::apply(e(ind));
+    }
+
+    bool is_contiguous() const { return e.is_contiguous(); }
+
+    bool has_shape(const size_t* shape, size_t n) const {
+        return e.has_shape(shape, n);
+    }
+
+    const auto& getCoordinateSystem() const { return e.getCoordinateSystem(); }
+
+   protected:
+    E e;
+};
+
+// operations
+
+struct Plus {
+    template <typename A, typename B>
+    static auto apply(const A& a, const B& b) {
+        return a + b;
+    }
+};
+struct Minus {
+    template <typename A, typename B>
+    static auto apply(const A& a, const B& b) {
+        return a - b;
+    }
+};
+struct Multiplies {
+    template <typename A, typename B>
+    static auto apply(const A& a, const B& b) {
+        return a * b;
+    }
+};
+struct Divides {
+    template <typename A, typename B>
+    static auto apply(const A& a, const B& b) {
+        return a / b;
+    }
+};
+
+struct Negate {
+    template <typename A>
+    static auto apply(const A& a) {
+        return -a;
+    }
+};
+// the math functions are called unqualified so that overloads for user types
+// (i.e. Boost.Units quantities) can be found by ADL.
+struct Abs {
+    template <typename A>
+    static auto apply(const A& a) {
+        using std::abs;
+        return abs(a);
+    }
+};
+struct Sqrt {
+    template <typename A>
+    static auto apply(const A& a) {
+        using std::sqrt;
+        return sqrt(a);
+    }
+};
+struct Exp {
+    template <typename A>
+    static auto apply(const A& a) {
+        using std::exp;
+        return exp(a);
+    }
+};
+struct Log {
+    template <typename A>
+    static auto apply(const A& a) {
+        using std::log;
+        return log(a);
+    }
+};
+struct Sin {
+    template <typename A>
+    static auto apply(const A& a) {
+        using std::sin;
+        return sin(a);
+    }
+};
+struct Cos {
+    template <typename A>
+    static auto apply(const A& a) {
+        using std::cos;
+        return cos(a);
+    }
+};
+
+/** True for types that can appear as an operand in a field expression. */
+template <typename T>
+struct IsOperand
+    : std::integral_constant<bool, IsField<T>::value ||
+                                       IsFieldExpression<T>::value> {};
+
+/** Wrap an operand in the node type used to store it in an expression. */
+template <typename T, typename Enable = void>
+struct Operand {
+    typedef Scalar<T> type;
+    static type make(const T& t) { return type(t); }
+};
+template <typename T>
+struct Operand<T, typename std::enable_if<IsField<T>::value>::type> {
+    typedef FieldRef<T> type;
+    static type make(const T& t) { return type(t); }
+};
+template <typename T>
+struct Operand<T, typename std::enable_if<IsFieldExpression<T>::value>::type> {
+    typedef T type;
+    static const type& make(const T& t) { return t; }
+};
+
+template <typename OP, typename L, typename R>
+auto make_binary(const L& l, const R& r) {
+    return BinaryExpression<OP, typename Operand<L>::type,
+                            typename Operand<R>::type>(Operand<L>::make(l),
+                                                       Operand<R>::make(r));
+}
+
+template <typename OP, typename E>
+auto make_unary(const E& e) {
+    return UnaryExpression<OP, typename Operand<E>::type>(Operand<E>::make(e));
+}
+
+/** True if either argument is a field or field expression. */
+template <typename L, typename R>
+using EnableIfOperands = typename std::enable_if<
+    IsOperand<L>::value || IsOperand<R>::value, int>::type;
+
+template <typename E>
+using EnableIfOperand = typename std::enable_if<IsOperand<E>::value, int>::type;
+
+/**
+ * Empty base class of Field. The operators and functions below are only found
+ * by argument dependent lookup, for fields (through this base) and expressions.
+ */
+struct Operators {};
+
+template <typename L, typename R, EnableIfOperands<L, R> = 0>
+auto operator+(const L& l, const R& r) {
+    return make_binary<Plus>(l, r);
+}
+template <typename L, typename R, EnableIfOperands<L, R> = 0>
+auto operator-(const L& l, const R& r) {
+    return make_binary<Minus>(l, r);
+}
+template <typename L, typename R, EnableIfOperands<L, R> = 0>
+auto operator*(const L& l, const R& r) {
+    return make_binary<Multiplies>(l, r);
+}
+template <typename L, typename R, EnableIfOperands<L, R> = 0>
+auto operator/(const L& l, const R& r) {
+    return make_binary<Divides>(l, r);
+}
+
+template <typename E, EnableIfOperand<E> = 0>
+auto operator-(const E& e) {
+    return make_unary<Negate>(e);
+}
+template <typename E, EnableIfOperand<E> = 0>
+auto abs(const E& e) {
+    return make_unary<Abs>(e);
+}
+template <typename E, EnableIfOperand<E> = 0>
+auto sqrt(const E& e) {
+    return make_unary<Sqrt>(e);
+}
+template <typename E, EnableIfOperand<E> = 0>
+auto exp(const E& e) {
+    return make_unary<Exp>(e);
+}
+template <typename E, EnableIfOperand<E> = 0>
+auto log(const E& e) {
+    return make_unary<Log>(e);
+}
+template <typename E, EnableIfOperand<E> = 0>
+auto sin(const E& e) {
+    return make_unary<Sin>(e);
+}
+template <typename E, EnableIfOperand<E> = 0>
+auto cos(const E& e) {
+    return make_unary<Cos>(e);
+}
+
+}  // namespace field_expressions
+
+template <typename OP, typename L, typename R>
+struct IsFieldExpression<field_expressions::BinaryExpression<OP, L, R>>
+    : std::true_type {};
+template <typename OP, typename E>
+struct IsFieldExpression<field_expressions::UnaryExpression<OP, E>>
+    : std::true_type {};
+
+#endif  // include protector
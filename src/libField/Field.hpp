@@ -4,14 +4,26 @@
 /** @file src/libField/Field.hpp
  */
 
+#include <algorithm>
 #include <array>
 #include <boost/multi_array.hpp>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <ostream>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 #include <vector>
 
+#include "Allocators.hpp"
 #include "CoordinateSystem.hpp"
+#include "Expressions.hpp"
+#include "FixedArray.hpp"
+#include "NDArray.hpp"
+#include "Points.hpp"
+#include "SIMD.hpp"
+#include "Stencil.hpp"
 #include "Utils.hpp"
 
 /** @class Field
@@ -27,16 +39,87 @@
  * This class associates a coordinate system with a multi-dimensional array.
  * Field elements are allocated in a single, multi-dimensional array. And a
  * CoordinateSystem is allocated for the coordinates.
+ *
+ * Copying a field copies its elements and coordinate system. Fields can opt
+ * in to copy-on-write (see setCopyOnWrite()), in which case copies share the
+ * elements and coordinate system until one of them is modified.
  */
 template <typename T, std::size_t N>
 using arrayND = boost::multi_array<T, N, std::allocator<T>>;
 template <typename T, std::size_t N>
 using viewND = boost::detail::multi_array::multi_array_view<T, N>;
+template <typename T, std::size_t N>
+using refND = boost::multi_array_ref<T, N>;
+
+namespace detail {
+/**
+ * The state of a field slice, allocated in one block: views of the elements
+ * and axes, the coordinate system made of the axis views (which refers to
+ * them, instead of copying them), and the elements and coordinate system of
+ * the sliced field, which are kept alive as long as the slice is.
+ */
+template <typename PA, typename PCS, size_t NDims>
+struct SliceState {
+    typedef typename PA::element quant_type;
+    typedef typename PCS::axis_type::element coord_type;
+    typedef viewND<quant_type, NDims> array_type;
+    typedef view1D<coord_type> axis_type;
+    typedef CoordinateSystem<coord_type, NDims, view1D> cs_type;
+
+    std::shared_ptr<PA> parent_data;
+    std::shared_ptr<PCS> parent_cs;
+    array_type data;
+    std::array<axis_type, NDims> axes;
+    cs_type cs;
+
+    template <typename I>
+    SliceState(std::shared_ptr<PA> d, std::shared_ptr<PCS> c, const I& ind)
+        : SliceState(std::move(d), std::move(c), ind,
+                     std::make_index_sequence<NDims>()) {}
+
+    SliceState(const SliceState&) = delete;
+    SliceState& operator=(const SliceState&) = delete;
+
+    /** Create the state of a slice of the elements d and coordinate system c
+     * made by the index generator ind. */
+    template <typename I>
+    static std::shared_ptr<SliceState> create(std::shared_ptr<PA> d,
+                                              std::shared_ptr<PCS> c,
+                                              const I& ind) {
+        auto s = std::make_shared<SliceState>(std::move(d), std::move(c), ind);
+        // the axis pointers held by cs refer to members, so they cannot own
+        // them (the state would own itself). cs aliases the pointers it hands
+        // out to the state instead.
+        s->cs.axes_owner = s;
+        return s;
+    }
+
+   private:
+    template <typename I, size_t... K>
+    SliceState(std::shared_ptr<PA> d, std::shared_ptr<PCS> c, const I& ind,
+               std::index_sequence<K...>)
+        : parent_data(std::move(d)),
+          parent_cs(std::move(c)),
+          data((*parent_data)[ind]),
+          axes{{parent_cs->slice_axis(ind, K)...}},
+          // the axes are members, so the pointers to them do not own them
+          cs({{std::shared_ptr<axis_type>(std::shared_ptr<void>(),
+                                          &axes[K])...}},
+             typename cs_type::ShareAxes()) {}
+};
+}  // namespace detail
+
+/**
+ * Reductions along one axis of a field (see Field::reduce_axis()).
+ *
+ * Integral uses the trapezoid rule with the coordinates of the axis.
+ */
+enum class AxisReduction { Sum, Mean, Min, Max, Integral };
 
 template <typename QUANT, size_t NUMDIMS, typename COORD = QUANT,
           template <typename, size_t> class ARRAYND = arrayND,
           template <typename> class ARRAY1D = array1D>
-class Field {
+class Field : public field_expressions::Operators {
    public:
     typedef ARRAYND<QUANT, NUMDIMS> array_type;
     typedef typename array_type::index index_type;
@@ -45,8 +128,135 @@ class Field {
    protected:
     std::shared_ptr<array_type> d;
     std::shared_ptr<cs_type> cs;
+    bool cow = false;
+    // fields that share d (or cs) through copy-on-write also share these, so
+    // their use counts are the number of fields sharing it. d and cs are also
+    // referenced by slices, which must not trigger a detach.
+    std::shared_ptr<void> d_owners;
+    std::shared_ptr<void> cs_owners;
 
    protected:
+    /**
+     * @internal
+     * Create a shared element array or coordinate system. The object (and its
+     * control block) is allocated with the same allocator as the field elements
+     * (or coordinate axes), see allocators::allocate_shared_like().
+     */
+    template <typename X, typename... Args>
+    static std::shared_ptr<X> _make_shared(Args&&... args) {
+        typedef typename std::conditional<std::is_same<X, cs_type>::value,
+                                          typename cs_type::axis_type,
+                                          array_type>::type A;
+        return allocators::allocate_shared_like<X, A>(
+            std::forward<Args>(args)...);
+    }
+
+    /**
+     * @internal
+     * The layout of the elements and axes, for the points of the field.
+     */
+    template <typename Q>
+    detail::PointGrid<Q, COORD, NUMDIMS> _point_grid() const {
+        BOOST_ASSERT_MSG(d, "Cannot iterate over an unallocated field.");
+        const auto& ccs = static_cast<const cs_type&>(*cs);
+        detail::PointGrid<Q, COORD, NUMDIMS> g;
+        g.origin = d->origin();
+        for (size_t k = 0; k < NUMDIMS; ++k) {
+            g.stride[k] = d->strides()[k];
+            g.shape[k] = d->shape()[k];
+            g.axis[k] = ccs.getAxis(k).origin();
+            g.axis_stride[k] = ccs.getAxis(k).strides()[0];
+        }
+        g.size = d->num_elements();
+        return g;
+    }
+
+    /**
+     * @internal
+     * Create a slice of the field (see slice()).
+     */
+    template <int NDims>
+    Field<QUANT, NDims, COORD, viewND, view1D> _slice(
+        const boost::detail::multi_array::index_gen<NUMDIMS, NDims>& ind)
+        const {
+        typedef detail::SliceState<array_type, cs_type, NDims> S;
+        auto s = S::create(d, cs, ind);
+        return Field<QUANT, NDims, COORD, viewND, view1D>(
+            std::shared_ptr<typename S::cs_type>(s, &s->cs),
+            std::shared_ptr<typename S::array_type>(s, &s->data));
+    }
+
+    /**
+     * @internal
+     * Give the field its own copy of the elements (or coordinate system) if
+     * copy-on-write is enabled and they are shared with another field. Must be
+     * called before the elements (or coordinate system) are modified, or a
+     * non-const reference to them is handed out.
+     */
+    void _detach_data() {
+        if (cow && _is_shared(d, d_owners)) {
+            d = _make_shared<array_type>(*d);
+            d_owners = std::make_shared<char>();
+        }
+    }
+    void _detach_cs() {
+        if (cow && _is_shared(cs, cs_owners)) {
+            cs = _make_shared<cs_type>(*cs, typename cs_type::DeepCopy());
+            cs_owners = std::make_shared<char>();
+        }
+    }
+    template <typename P>
+    static bool _is_shared(const P& p, const std::shared_ptr<void>& owners) {
+        return p && p.use_count() > 1 && (!owners || owners.use_count() > 1);
+    }
+
+    /**
+     * @internal
+     * Make the field a copy of f. Fields that do not own their elements (i.e.
+     * slices) share the view state of f, which keeps the sliced field alive.
+     */
+    void _copy(const Field& f, std::true_type) { reset(*f.cs, *f.d); }
+    void _copy(const Field& f, std::false_type) {
+        d = f.d;
+        cs = f.cs;
+    }
+
+    /**
+     * @internal
+     * Return a deep copy of the field (see clone()).
+     */
+    Field _clone(std::true_type) const {
+        Field f;
+        f._copy(*this, std::true_type());
+        f.setCopyOnWrite(cow);
+        return f;
+    }
+    Field<QUANT, NUMDIMS, COORD> _clone(std::false_type) const {
+        std::array<size_t, NUMDIMS> sizes;
+        for (size_t i = 0; i < NUMDIMS; ++i) sizes[i] = d->shape()[i];
+        Field<QUANT, NUMDIMS, COORD> f(sizes);
+        for (size_t i = 0; i < NUMDIMS; ++i)
+            std::copy(getAxis(i).begin(), getAxis(i).end(),
+                      f.getAxis(i).begin());
+        f.getData() = *d;
+        f.setCopyOnWrite(cow);
+        return f;
+    }
+
+    /**
+     * @internal
+     * Assign f (a copy) to the field (see operator=()).
+     */
+    void _assign(Field& f, std::true_type) { swap(f); }
+    void _assign(Field& f, std::false_type) {
+        if (d && f.d && d != f.d &&
+            std::equal(d->shape(), d->shape() + NUMDIMS, f.d->shape())) {
+            _apply_field(f, [](auto& x, const auto& y) { x = y; });
+        } else {
+            swap(f);
+        }
+    }
+
     /**
      * @internal
      * Utility function for converting 1d index to an Nd
@@ -56,7 +266,7 @@ class Field {
         auto shape = d->shape();
 
         std::array<size_t, NUMDIMS> ind;
-        int NN = shape[0];
+        size_t NN = shape[0];
         for (size_t j = 1; j < NUMDIMS; ++j) NN *= shape[j];
         for (size_t j = 0; j < NUMDIMS; ++j) {
             NN /= shape[j];
@@ -66,6 +276,389 @@ class Field {
         return ind;
     }
 
+    /**
+     * @internal
+     * Utility function for calling op(element, i) on every element of the
+     * field in parallel, where i is the element's 1d (row-major) index.
+     *
+     * Fields that own a contiguous block of elements are traversed linearly
+     * through the data pointer. Other fields (i.e. sliced views) fall back to
+     * converting each 1d index to an Nd index.
+     */
+    template <typename OP>
+    void _for_each_element(OP op) {
+        _detach_data();
+        auto N = d->num_elements();
+        auto p = detail::contiguous_data(*d);
+        if (p) {
+            detail::for_each_block(N, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) op(p[i], i);
+            });
+        } else {
+            detail::for_each_block(N, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) op((*d)(_1d2nd(i)), i);
+            });
+        }
+    }
+
+    /**
+     * @internal
+     * Utility function for calling op(i, ind, x) on the elements in the 1d
+     * index range [b,e), in order, where ind is the Nd index of element i and
+     * x is its coordinate (only computed if COORDS is true).
+     *
+     * The elements are walked in row-major order, incrementing the index and
+     * updating only the coordinates along axes whose index changed, rather
+     * than recomputing the full index and coordinate for every element.
+     */
+    template <bool COORDS, typename OP>
+    void _walk(size_t b, size_t e, OP op) const {
+        if (b >= e) return;
+        auto shape = d->shape();
+        std::array<const typename cs_type::axis_type*, NUMDIMS> axes;
+        for (size_t j = 0; j < NUMDIMS; ++j)
+            axes[j] = &static_cast<const cs_type&>(*cs).getAxis(j);
+
+        auto ind = this->_1d2nd(b);
+        std::array<COORD, NUMDIMS> x{};
+        if (COORDS)
+            for (size_t j = 0; j < NUMDIMS; ++j) x[j] = (*axes[j])[ind[j]];
+        for (size_t i = b; i < e; ++i) {
+            if (i > b) {
+                // increment the index, carrying into the slower axes
+                for (size_t j = NUMDIMS; j-- > 0;) {
+                    if (++ind[j] < shape[j]) {
+                        if (COORDS) x[j] = (*axes[j])[ind[j]];
+                        break;
+                    }
+                    ind[j] = 0;
+                    if (COORDS) x[j] = (*axes[j])[0];
+                }
+            }
+            op(i, ind, x);
+        }
+    }
+
+    /**
+     * @internal
+     * Utility function for calling op(element, ind, x) on every element of
+     * the field in parallel, where ind is the element's Nd index and x is its
+     * coordinate (only computed if COORDS is true).
+     *
+     * Each thread walks its block of elements with _walk().
+     */
+    template <bool COORDS, typename OP>
+    void _for_each_index(OP op) {
+        _detach_data();
+        auto p = detail::contiguous_data(*d);
+        detail::for_each_block(d->num_elements(), [&](size_t b, size_t e) {
+            this->template _walk<COORDS>(
+                b, e, [&](size_t i, const auto& ind, const auto& x) {
+                    op(p ? p[i] : (*d)(ind), ind, x);
+                });
+        });
+    }
+
+    /**
+     * @internal
+     * Utility function for calling op(element, q) on every element of the
+     * field in parallel.
+     *
+     * op must be a generic callable. For contiguous float and double fields,
+     * it is called with vector registers by the kernels in SIMD.hpp.
+     */
+    template <typename Q, typename OP>
+    void _apply_scalar(const Q& q, OP op) {
+        _detach_data();
+        _apply_scalar(q, op, simd_kernels::IsVectorizableScalar<QUANT, Q>());
+    }
+
+    template <typename Q, typename OP>
+    void _apply_scalar(const Q& q, OP op, std::false_type) {
+        _for_each_element([&](auto& x, size_t) { op(x, q); });
+    }
+
+    template <typename Q, typename OP>
+    void _apply_scalar(const Q& q, OP op, std::true_type) {
+        auto p = detail::contiguous_data(*d);
+        const QUANT v = q;
+        if (!p || !simd_kernels::is_exact(v, q))
+            return _apply_scalar(q, op, std::false_type());
+        detail::for_each_block(d->num_elements(), [&](size_t b, size_t e) {
+            simd_kernels::apply_value(p + b, v, e - b, op);
+        });
+    }
+
+    /**
+     * @internal
+     * Utility function for calling op(element, other) on every element of the
+     * field in parallel, where other is the corresponding element of field f.
+     *
+     * If both fields are contiguous, they are traversed linearly (and float
+     * and double fields are handled by the kernels in SIMD.hpp).
+     */
+    template <typename OP>
+    void _apply_field(const Field& f, OP op) {
+        BOOST_ASSERT(f.size() == this->size());
+        _detach_data();
+        auto N = d->num_elements();
+        auto p = detail::contiguous_data(*d);
+        auto q = detail::contiguous_data(f.getData());
+        if (p && q) {
+            _apply_array(p, q, N, op, simd_kernels::IsVectorizable<QUANT>());
+        } else {
+            detail::for_each_block(N, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    auto ind = this->_1d2nd(i);
+                    op((*d)(ind), f(ind));
+                }
+            });
+        }
+    }
+
+    template <typename T, typename OP>
+    static void _apply_array(T* p, const T* q, size_t N, OP op,
+                             std::false_type) {
+        detail::for_each_block(N, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) op(p[i], q[i]);
+        });
+    }
+
+    template <typename T, typename OP>
+    static void _apply_array(T* p, const T* q, size_t N, OP op,
+                             std::true_type) {
+        detail::for_each_block(N, [&](size_t b, size_t e) {
+            simd_kernels::apply_array(p + b, q + b, e - b, op);
+        });
+    }
+
+    /**
+     * @internal
+     * Utility function for calling op(element, value) on every element of the
+     * field in parallel, where value is the corresponding element of the field
+     * expression expr.
+     *
+     * The shape of the expression is checked once, before the loop. If the
+     * field and every field in the expression are contiguous, they are
+     * traversed linearly.
+     */
+    template <typename E, typename OP>
+    void _apply_expression(const E& expr, OP op) {
+        BOOST_ASSERT(expr.has_shape(d->shape(), NUMDIMS));
+        _detach_data();
+        auto N = d->num_elements();
+        auto p = detail::contiguous_data(*d);
+        if (p && expr.is_contiguous()) {
+            detail::for_each_block(N, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) op(p[i], expr[i]);
+            });
+        } else {
+            detail::for_each_block(N, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) {
+                    auto ind = this->_1d2nd(i);
+                    op((*d)(ind), expr(ind));
+                }
+            });
+        }
+    }
+
+    /**
+     * @internal
+     * Return a pointer to the elements in the 1d index range [b,e). Fields
+     * that are not contiguous are copied into buf first.
+     */
+    const QUANT* _block_data(size_t b, size_t e,
+                             std::vector<QUANT>& buf) const {
+        auto p = detail::contiguous_data(*d);
+        if (p) return p + b;
+        buf.resize(e - b);
+        this->template _walk<false>(
+            b, e, [&](size_t i, const auto& ind, const auto&) {
+                buf[i - b] = (*d)(ind);
+            });
+        return buf.data();
+    }
+
+    /**
+     * @internal
+     * Reduce the elements of the field in parallel (see
+     * detail::reduce_blocks()). block(b, x, n) returns the result for the n
+     * elements x[0..n), whose 1d indices start at b.
+     */
+    template <typename T, typename BLOCK, typename COMBINE>
+    T _reduce(T init, BLOCK block, COMBINE combine,
+              ReductionMode mode) const {
+        return detail::reduce_blocks(
+            d->num_elements(), init,
+            [&](size_t b, size_t e) {
+                std::vector<QUANT> buf;
+                return block(b, this->_block_data(b, e, buf), e - b);
+            },
+            combine, mode);
+    }
+
+    /**
+     * @internal
+     * Return the element that is first in the order given by less(x,y)
+     * (lowest 1d index for ties). NaN elements are skipped, unless all
+     * elements are NaN.
+     */
+    template <typename LESS>
+    auto _extremum(LESS less) const {
+        BOOST_ASSERT(d->num_elements() > 0);
+        typedef std::pair<QUANT, size_t> E;
+        const size_t none = std::numeric_limits<size_t>::max();
+        auto better = [&](const E& x, const E& y) {
+            if (y.second == none) return false;
+            if (x.second == none) return true;
+            // (x != x is true for NaN)
+            if (x.first != x.first) return y.first == y.first;
+            return less(y.first, x.first);
+        };
+        auto m = _reduce(
+            E(QUANT(), none),
+            [&](size_t b, const QUANT* x, size_t n) {
+                E r(x[0], b);
+                for (size_t i = 1; i < n; ++i)
+                    if (better(r, E(x[i], b + i))) r = E(x[i], b + i);
+                return r;
+            },
+            [&](const E& x, const E& y) {
+                // keep the lowest index for ties
+                if (better(x, y) || (y.second < x.second && !better(y, x)))
+                    return y;
+                return x;
+            },
+            ReductionMode::Fast);
+
+        Extremum r;
+        r.value = m.first;
+        const auto ind = _1d2nd(m.second);
+        const auto& ccs = static_cast<const cs_type&>(*cs);
+        for (size_t j = 0; j < NUMDIMS; ++j) {
+            r.index[j] = ind[j];
+            r.coord[j] = ccs.getAxis(j)[ind[j]];
+        }
+        return r;
+    }
+
+    /**
+     * @internal
+     * Reduce len rows of n elements into dst, where element j of row i is
+     * src[i * stride + j * jstride]: dst[j] = init(first row), then
+     * step(dst[j], x, i) for the element x of each following row. The rows
+     * are visited in order, and the n reductions are interleaved.
+     */
+    template <typename INIT, typename STEP>
+    static void _reduce_rows(const QUANT* src, size_t stride, size_t jstride,
+                             size_t len, QUANT* dst, size_t n, INIT init,
+                             STEP step) {
+        if (len == 0) {
+            std::fill(dst, dst + n, QUANT());
+            return;
+        }
+        for (size_t j = 0; j < n; ++j) dst[j] = init(src[j * jstride]);
+        for (size_t i = 1; i < len; ++i) {
+            const QUANT* row = src + i * stride;
+            for (size_t j = 0; j < n; ++j) step(dst[j], row[j * jstride], i);
+        }
+    }
+
+    /**
+     * @internal
+     * Allocate the field with a copy of the coordinate system used by a field
+     * expression (or a field). The elements are not copied. Fields that do not
+     * own their elements (i.e. views) cannot be allocated.
+     */
+    template <typename E>
+    void _reset_like(const E& expr, std::true_type) {
+        reset(_make_shared<cs_type>(expr.getCoordinateSystem().getAxes()));
+    }
+    void _reset_like(const Field& f, std::true_type) {
+        reset(_make_shared<cs_type>(*f.cs, typename cs_type::DeepCopy()));
+    }
+    template <typename E>
+    void _reset_like(const E& expr, std::false_type) {
+        BOOST_ASSERT_MSG(d, "Cannot allocate a field view.");
+    }
+
+    /**
+     * @internal
+     * Make the field elements an array with the given sizes. If the field is
+     * the only owner of its current array, and the number of elements is the
+     * same, the array is reshaped instead of reallocated.
+     */
+    template <typename S>
+    void _reallocate(const S& sizes) {
+        size_t n = 1;
+        for (size_t i = 0; i < NUMDIMS; ++i) n *= sizes[i];
+        if (d && d.use_count() == 1 && d->num_elements() == n)
+            d->reshape(sizes);
+        else
+            d = _make_shared<array_type>(sizes);
+    }
+
+    /**
+     * @internal
+     * Make the coordinate system one with the given sizes. If the field is
+     * the only owner of its current coordinate system, and the axes already
+     * have the given sizes, it is kept.
+     */
+    template <typename S>
+    void _reallocate_cs(const S& sizes) {
+        bool reuse = cs && cs.use_count() == 1;
+        for (size_t i = 0; reuse && i < NUMDIMS; ++i)
+            reuse = cs->size(i) == static_cast<size_t>(sizes[i]);
+        if (!reuse) cs = _make_shared<cs_type>(sizes);
+    }
+
+    /**
+     * @internal
+     * Multilinear interpolation of the field at coordinate x. ind holds the
+     * bracketing interval indices of the previous query (or -1), which are
+     * used as hints and updated.
+     */
+    template <typename X>
+    auto _interp(const X& x, std::array<int, NUMDIMS>& ind) const {
+        const cs_type& c = *cs;
+        std::array<double, NUMDIMS> w;
+        for (size_t k = 0; k < NUMDIMS; ++k) {
+            const auto& a = c.getAxis(k);
+            ind[k] = c.bracket(k, x[k], ind[k]);
+            if (a.size() < 2) {
+                w[k] = 0;
+                continue;
+            }
+            const double t =
+                (x[k] - a[ind[k]]) / (a[ind[k] + 1] - a[ind[k]]);
+            w[k] = std::min(std::max(t, 0.), 1.);
+        }
+
+        // sum the contributions of the 2^NUMDIMS corners of the cell. the
+        // corners are addressed relative to the first one with the strides.
+        std::array<size_t, NUMDIMS> first;
+        for (size_t k = 0; k < NUMDIMS; ++k) first[k] = ind[k];
+        const QUANT* p = &(*d)(first);
+        auto strides = d->strides();
+        decltype(std::declval<double>() * std::declval<QUANT>()) r{};
+        for (size_t n = 0; n < (size_t(1) << NUMDIMS); ++n) {
+            double wn = 1;
+            std::ptrdiff_t offset = 0;
+            for (size_t k = 0; k < NUMDIMS; ++k) {
+                if ((n >> k) & 1) {
+                    wn *= w[k];
+                    offset += strides[k];
+                } else {
+                    wn *= 1 - w[k];
+                }
+            }
+            // this also skips the corners past the end of single point axes
+            if (wn == 0) continue;
+            r += wn * p[offset];
+        }
+        return r;
+    }
+
    public:
 #if SERIALIZATION_ENABLED
     template <class Archive>
@@ -86,7 +679,23 @@ class Field {
     Field(Field&&) = default;
     ~Field() = default;
 
-    Field(const Field& f) { reset(*f.cs, *f.d); }
+    /**
+     * @brief Copy a field.
+     *
+     * The elements and coordinate system are copied, unless copy-on-write is
+     * enabled for f, in which case they are shared with f (see
+     * setCopyOnWrite()). The copy inherits the copy-on-write setting of f.
+     */
+    Field(const Field& f) : cow(f.cow) {
+        if (cow) {
+            d = f.d;
+            cs = f.cs;
+            d_owners = f.d_owners;
+            cs_owners = f.cs_owners;
+        } else {
+            _copy(f, std::is_constructible<array_type, std::vector<size_t>>());
+        }
+    }
 
     /**
      * @brief Create a new field and allocate memory for grid defined by dims.
@@ -121,29 +730,60 @@ class Field {
     }
     Field(std::shared_ptr<cs_type> cs_) { reset(cs_); }
 
+    /**
+     * @brief Create a field that shares an existing coordinate system and
+     * element array (neither is copied).
+     */
+    Field(std::shared_ptr<cs_type> cs_, std::shared_ptr<array_type> d_)
+        : d(std::move(d_)), cs(std::move(cs_)) {}
+
     Field(cs_type& cs_, array_type& d_) { reset(cs_, d_); };
 
+    /**
+     * @brief Create a new field from a field expression.
+     *
+     * @param expr an expression built from fields and scalars (see
+     * Expressions.hpp).
+     *
+     * The coordinate system is copied from the left-most field in the
+     * expression.
+     *
+     * @code
+     * Field<double,2> T = 2*A + B;
+     * @endcode
+     */
+    template <typename E, typename std::enable_if<IsFieldExpression<E>::value,
+                                                  int>::type = 0>
+    Field(const E& expr) {
+        *this = expr;
+    }
+
     /**
      * @brief Reallocate a field with new dimensions.
      *
      * @param dims The size of the new field along each dimension.
+     *
+     * If the field is not shared and already has the same number of elements
+     * (or axes of the same sizes), the existing memory is reused, and the
+     * values of the elements (or coordinates) are unspecified. Otherwise new
+     * memory is allocated.
      */
     template <typename... Dims>
     void reset(Dims... dims) {
-        cs = std::make_shared<cs_type>(dims...);
-        std::array<size_t, NUMDIMS> sizes({static_cast<size_t>(dims)...});
-        d = std::make_shared<array_type>(sizes);
+        reset(std::array<size_t, NUMDIMS>({static_cast<size_t>(dims)...}));
     }
 
     /**
      * @brief Reallocate a field with new dimensions.
      *
      * @param sizes An array of the new field sizes along each dimension.
+     *
+     * Existing memory is reused when possible (see reset(Dims...)).
      */
     template <typename I>
     void reset(std::array<I, NUMDIMS> sizes) {
-        cs = std::make_shared<cs_type>(sizes);
-        d = std::make_shared<array_type>(sizes);
+        _reallocate_cs(sizes);
+        _reallocate(sizes);
     }
 
     /**
@@ -152,7 +792,9 @@ class Field {
      * @param cs_ a shared pointer to an existing coordinate system.
      *
      * New memory will be allocated for the field elements, but not for
-     * the coordinate system.
+     * the coordinate system. If the field is not shared and already has the
+     * same number of elements, the existing memory is reused instead (see
+     * reset(Dims...)).
      */
     void reset(std::shared_ptr<cs_type> cs_) {
         cs = cs_;
@@ -160,7 +802,7 @@ class Field {
         std::vector<size_t> sizes(NUMDIMS);
         for (size_t i = 0; i < NUMDIMS; ++i) sizes[i] = cs->size(i);
 
-        d = std::make_shared<array_type>(sizes);
+        _reallocate(sizes);
     }
 
     /**
@@ -174,10 +816,59 @@ class Field {
      * and coordinate system will be used.
      */
     void reset(cs_type& cs_, array_type& d_) {
-        d = std::make_shared<array_type>(d_);
-        cs = std::make_shared<cs_type>(cs_.getAxes());
+        d = _make_shared<array_type>(d_);
+        cs = _make_shared<cs_type>(cs_, typename cs_type::DeepCopy());
     };
 
+    /**
+     * @brief Enable (or disable) copy-on-write for the field.
+     *
+     * When copy-on-write is enabled, copies of the field share its elements
+     * and coordinate system instead of copying them, so passing large fields
+     * by value is cheap. A field gives itself a private copy of the elements
+     * (or of the coordinate system) the first time they are modified, or a
+     * non-const reference or pointer to them is requested, while they are
+     * shared. Copies inherit the setting.
+     *
+     * References and pointers obtained before a field is copied are not
+     * tracked, and writing through them will modify every copy. Slices of the
+     * field, and coordinate systems shared on purpose (i.e. with
+     * getCoordinateSystemPtr()), are not copies: they do not cause a detach,
+     * and keep referring to the field's elements and coordinates.
+     *
+     * Detaching replaces the field's elements, so it is not thread safe. The
+     * field's own parallel operations detach before they start, but element
+     * access from a user's parallel loop (i.e. calling the non-const
+     * operator() in an OpenMP loop) races if the elements are still shared.
+     * Detach the field first, with a call to the non-const data() (or use a
+     * clone()), before accessing its elements from several threads.
+     *
+     * @code
+     * Field<double,3> T(100,100,100);
+     * T.setCopyOnWrite();
+     * auto U = T;  // no copy
+     * U += 1;      // U gets its own elements here, T is unchanged
+     * @endcode
+     */
+    void setCopyOnWrite(bool enable = true) {
+        cow = enable;
+        if (cow && !d_owners) d_owners = std::make_shared<char>();
+        if (cow && !cs_owners) cs_owners = std::make_shared<char>();
+    }
+    bool getCopyOnWrite() const { return cow; }
+
+    /**
+     * @brief Return a deep copy of the field, regardless of the copy-on-write
+     * setting.
+     *
+     * The clone of a field that does not own its elements (i.e. a slice) is
+     * a Field<QUANT,NUMDIMS,COORD> that owns a copy of the elements and
+     * coordinates.
+     */
+    auto clone() const {
+        return _clone(std::is_constructible<array_type, std::vector<size_t>>());
+    }
+
     // ELEMENT ACCESS
 
     /**
@@ -204,7 +895,7 @@ class Field {
      */
     template <typename I,
               typename std::enable_if<IsIndexCont<I>::value, int>::type = 0>
-    const auto& operator()(I i) const {
+    const auto& operator()(const I& i) const {
         return (*d)(i);
     }
 
@@ -232,7 +923,8 @@ class Field {
      */
     template <typename I,
               typename std::enable_if<IsIndexCont<I>::value, int>::type = 0>
-    auto& operator()(I i) {
+    auto& operator()(const I& i) {
+        _detach_data();
         return (*d)(i);
     }
 
@@ -284,11 +976,17 @@ class Field {
         typename I, typename... Args,
         typename std::enable_if<std::is_integral<I>::value, int>::type = 0>
     auto& operator()(I i, Args... args) {
+        _detach_data();
         return (*d)(std::array<I, NUMDIMS>({i, args...}));
     }
 
     template <typename I>
     auto operator[](I i) const {
+        return static_cast<const array_type&>(*d)[i];
+    }
+    template <typename I>
+    auto operator[](I i) {
+        _detach_data();
         return (*d)[i];
     }
 
@@ -296,19 +994,28 @@ class Field {
      * @brief Return a shared pointer to the coordinate system used by the
      * field.
      */
-    auto getCoordinateSystemPtr() { return cs; };
+    auto getCoordinateSystemPtr() {
+        _detach_cs();
+        return cs;
+    };
 
     /**
      * @brief Return a reference to the coordinate system used by the field.
      */
-    auto& getCoordinateSystem() { return *cs; };
+    auto& getCoordinateSystem() {
+        _detach_cs();
+        return *cs;
+    };
 
     /**
      * @brief Return a reference to the i'th axis in the coordinate system used
      * by the field.
      * @param i The index (zero-offset) of the axis to return.
      */
-    auto& getAxis(size_t i) { return cs->getAxis(i); }
+    auto& getAxis(size_t i) {
+        _detach_cs();
+        return cs->getAxis(i);
+    }
 
     /**
      * @brief Return a const reference to the coordinate system used by the
@@ -320,7 +1027,9 @@ class Field {
      * used by the field.
      * @param i The index (zero-offset) of the axis to return.
      */
-    const auto& getAxis(size_t i) const { return cs->getAxis(i); }
+    const auto& getAxis(size_t i) const {
+        return static_cast<const cs_type&>(*cs).getAxis(i);
+    }
 
     /**
      * @brief Set the coordinates of the coordinate system.
@@ -341,6 +1050,7 @@ class Field {
      */
     template <typename... Args>
     auto setCoordinateSystem(Args... args) {
+        _detach_cs();
         cs->set(args...);
     }
 
@@ -401,35 +1111,166 @@ class Field {
         return cs->nearest(args...);
     }
 
+    /**
+     * @brief Batched lookups of many coordinates along one axis.
+     *
+     * These functions forward the arguments to
+     * CoordinateSystem::lower_bound_batched() (upper_bound_batched(),
+     * nearest_batched()) of the coordinate system used by the field. They are
+     * much faster than calling lower_bound() for each coordinate when the
+     * coordinates are sorted (i.e. particle positions or resampling targets).
+     *
+     * @code
+     * std::vector<double> x = ...;  // sorted
+     * std::vector<int> ind(x.size());
+     * F.lower_bound_batched(0, x, ind);
+     * @endcode
+     */
+    template <typename... Args>
+    auto lower_bound_batched(Args&&... args) const {
+        return cs->lower_bound_batched(std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    auto upper_bound_batched(Args&&... args) const {
+        return cs->upper_bound_batched(std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    auto nearest_batched(Args&&... args) const {
+        return cs->nearest_batched(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Returns a lookup cursor for the coordinate system used by the
+     * field (see CoordinateSystem::Cursor), for repeated lookups of slowly
+     * moving coordinates.
+     *
+     * The cursor refers to the field's current coordinate system, so it is
+     * invalidated if the axes are modified (i.e. by setCoordinateSystem()),
+     * or the coordinate system is replaced (i.e. by reset(), or a
+     * copy-on-write detach).
+     */
+    auto cursor() const { return cs->cursor(); }
+
+    /**
+     * @brief Return the value of the field at the given coordinate, computed
+     * by (multi)linear interpolation between the surrounding elements.
+     *
+     * @param args the coordinate along each dimension.
+     *
+     * The axes do not need to be uniform. Coordinates outside of the
+     * coordinate system are clamped to its boundary (i.e. the value is
+     * extrapolated as a constant).
+     *
+     * @code
+     * Field<double,3> F(10,20,30);
+     * ...
+     * auto v = F.interp(0.1, 2.3, -1.5);
+     * @endcode
+     */
+    template <typename... Args>
+    auto interp(Args... args) const {
+        BOOST_STATIC_ASSERT_MSG(sizeof...(Args) == NUMDIMS,
+                                "Field<QUANT,NUMDIMS> interp called with "
+                                "wrong number of arguments.");
+        const std::array<COORD, NUMDIMS> x{{static_cast<COORD>(args)...}};
+        return interp(x);
+    }
+
+    /**
+     * @brief Return the value of the field at the coordinate given in an
+     * array, computed by (multi)linear interpolation.
+     */
+    auto interp(const std::array<COORD, NUMDIMS>& x) const {
+        std::array<int, NUMDIMS> ind;
+        ind.fill(-1);
+        return _interp(x, ind);
+    }
+
+    /**
+     * @brief Interpolate the field at many coordinates (see interp()).
+     *
+     * @param points a container of points, where points[i][k] is the k'th
+     * coordinate of the i'th point (i.e. a std::vector<std::array<double,N>>).
+     * @return a vector with the value of the field at each point.
+     *
+     * Points are interpolated in PARALLEL. Each thread processes a contiguous
+     * range of points, and starts the search for each point from the cell that
+     * contained the previous one, so points that are close to each other in
+     * the container (i.e. sorted along a particle track) are located without
+     * searching the axes.
+     */
+    template <typename P>
+    auto interp_batched(const P& points) const {
+        typedef decltype(std::declval<double>() * std::declval<QUANT>()) V;
+        std::vector<V> out(points.size());
+        detail::for_each_block(points.size(), [&](size_t b, size_t e) {
+            std::array<int, NUMDIMS> ind;
+            ind.fill(-1);
+            std::array<COORD, NUMDIMS> x;
+            for (size_t i = b; i < e; ++i) {
+                for (size_t k = 0; k < NUMDIMS; ++k) x[k] = points[i][k];
+                out[i] = this->_interp(x, ind);
+            }
+        });
+        return out;
+    }
+
     // data access
-    auto getDataPtr() { return d; };
+    auto getDataPtr() {
+        _detach_data();
+        return d;
+    };
     const auto& getData() const { return *d; };
-    auto& getData() { return *d; };
+    auto& getData() {
+        _detach_data();
+        return *d;
+    };
 
     const auto data() const { return d->data(); }
-    auto data() { return d->data(); }
+    auto data() {
+        _detach_data();
+        return d->data();
+    }
 
+    /**
+     * @brief Return a view of part of the field, selected by an index
+     * generator (e.g. indices[2][IRange()]).
+     *
+     * The view refers to the elements and coordinates of this field (nothing
+     * is copied), and keeps them alive. Its state is created in a single
+     * allocation, and shared by copies of the view.
+     */
     template <int NDims>
     const auto slice(
         const boost::detail::multi_array::index_gen<NUMDIMS, NDims>& ind)
         const {
-        // get sliced data
-        auto d_ = d->operator[](ind);
-        // get sliced coordinate system
-        auto cs_ = cs->slice(ind);
-
-        return Field<QUANT, NDims, COORD, viewND, view1D>(cs_, d_);
+        return _slice(ind);
     }
 
     template <int NDims>
     auto slice(
         const boost::detail::multi_array::index_gen<NUMDIMS, NDims>& ind) {
-        // get sliced data
-        auto d_ = d->operator[](ind);
-        // get sliced coordinate system
-        auto cs_ = cs->slice(ind);
+        _detach_data();
+        _detach_cs();
+        return _slice(ind);
+    }
 
-        return Field<QUANT, NDims, COORD, viewND, view1D>(cs_, d_);
+    /**
+     * @brief Return the points of the field as a random access range. Each
+     * point gives the index of an element, its coordinates, and a reference
+     * to the element (see Points.hpp).
+     *
+     * @code
+     * for (auto p : T.points()) p.value() = std::sin(p.coord(0));
+     * @endcode
+     */
+    auto points() {
+        _detach_data();
+        return FieldPoints<QUANT, COORD, NUMDIMS>(_point_grid<QUANT>());
+    }
+    auto points() const {
+        return FieldPoints<const QUANT, COORD, NUMDIMS>(
+            _point_grid<const QUANT>());
     }
 
     auto size() const { return d->num_elements(); }
@@ -452,12 +1293,8 @@ class Field {
      */
     template <typename F>
     auto set_f(F f) -> decltype((*d)(0) = f(cs->getCoord(_1d2nd(0))), void()) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) = f(cs->getCoord(ind));
-        }
+        _for_each_index<true>(
+            [&](auto& v, const auto& ind, const auto& x) { v = f(x); });
     }
 
     /**
@@ -481,13 +1318,10 @@ class Field {
     auto set_f(F f)
         -> decltype((bool)f(cs->getCoord(_1d2nd(0))),
                     (*d)(0) = f(cs->getCoord(_1d2nd(0))).value(), void()) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            auto val = f(cs->getCoord(ind));
-            if (val) d->operator()(ind) = val.value();
-        }
+        _for_each_index<true>([&](auto& v, const auto& ind, const auto& x) {
+            auto val = f(x);
+            if (val) v = val.value();
+        });
     }
 
     /**
@@ -509,12 +1343,8 @@ class Field {
      */
     template <typename F>
     auto set_f(F f) -> decltype((*d)(0) = f(_1d2nd(0), cs), void()) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) = f(ind, cs);
-        }
+        _for_each_index<false>(
+            [&](auto& v, const auto& ind, const auto& x) { v = f(ind, cs); });
     }
 
     /**
@@ -538,12 +1368,304 @@ class Field {
     template <typename F>
     auto set_f(F f) -> decltype((bool)f(_1d2nd(0), cs),
                                 (*d)(0) = f(_1d2nd(0), cs).value(), void()) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
+        _for_each_index<false>([&](auto& v, const auto& ind, const auto& x) {
             auto val = f(ind, cs);
-            if (val) d->operator()(ind) = val.value();
+            if (val) v = val.value();
+        });
+    }
+
+    /**
+     * @brief Update each element of a field using a callable that takes an
+     * array-like container of *coordinates* and the element's current value
+     * as arguments and returns the element's new value.
+     *
+     * This is set_f() for updates that depend on the current value (e.g.
+     * multiplying by a coordinate dependent profile, or adding a source
+     * term). The elements are read and written in a single PARRALLEL pass,
+     * without a temporary field. Callable should NOT depend on the order of
+     * being called.
+     *
+     * @param f a callable object (function, funtor, lambda, std::function,
+     * etc.) that accepts two arguments and returns a value.
+     *
+     * Arguments passed to callable f will be an array of coordinates, and the
+     * element (which may be taken by value or const reference).
+     *
+     * @code
+     * T.update_f([](auto x, double v) { return v * std::exp(-x[0]); });
+     * @endcode
+     */
+    template <typename F>
+    auto update_f(F f) -> decltype((*d)(0) = f(cs->getCoord(_1d2nd(0)),
+                                               (*d)(0)),
+                                   void()) {
+        _for_each_index<true>(
+            [&](auto& v, const auto& ind, const auto& x) { v = f(x, v); });
+    }
+
+    /**
+     * @brief Update each element of a field using a callable that takes an
+     * array-like container of *coordinates* and the element's current value
+     * as arguments and returns an optional new value.
+     *
+     * If the optional (boost::optional or std::optional) returned by f is
+     * set, the element is set to its value. Otherwise, the element is left
+     * untouched. Field may be evaluated in PARRALLEL. Callable should NOT
+     * depend on the order of being called.
+     */
+    template <typename F>
+    auto update_f(F f)
+        -> decltype((bool)f(cs->getCoord(_1d2nd(0)), (*d)(0)),
+                    (*d)(0) = f(cs->getCoord(_1d2nd(0)), (*d)(0)).value(),
+                    void()) {
+        _for_each_index<true>([&](auto& v, const auto& ind, const auto& x) {
+            auto val = f(x, v);
+            if (val) v = val.value();
+        });
+    }
+
+    /**
+     * @brief Update each element of a field using a callable that takes an
+     * array-like container of *coordinates* and a (non-const) reference to
+     * the element, and modifies the element in place.
+     *
+     * Field may be evaluated in PARRALLEL. Callable should NOT depend on the
+     * order of being called.
+     *
+     * @code
+     * T.update_f([&](auto x, double& v) { v += dt * source(x); });
+     * @endcode
+     */
+    template <typename F>
+    auto update_f(F f) -> typename std::enable_if<
+        std::is_void<decltype(f(cs->getCoord(_1d2nd(0)), (*d)(0)))>::value>::
+        type {
+        _for_each_index<true>(
+            [&](auto& v, const auto& ind, const auto& x) { f(x, v); });
+    }
+
+    /**
+     * @brief Update each element of a field using a callable that takes an
+     * array-like container of *indices*, a pointer to the coordinate system
+     * and the element's current value as arguments and returns the element's
+     * new value.
+     *
+     * Field may be evaluated in PARRALLEL. Callable should NOT depend on the
+     * order of being called.
+     */
+    template <typename F>
+    auto update_f(F f)
+        -> decltype((*d)(0) = f(_1d2nd(0), cs, (*d)(0)), void()) {
+        _for_each_index<false>([&](auto& v, const auto& ind, const auto& x) {
+            v = f(ind, cs, v);
+        });
+    }
+
+    /**
+     * @brief Update each element of a field using a callable that takes an
+     * array-like container of *indices*, a pointer to the coordinate system
+     * and the element's current value as arguments and returns an optional
+     * new value.
+     *
+     * If the optional returned by f is set, the element is set to its value.
+     * Otherwise, the element is left untouched. Field may be evaluated in
+     * PARRALLEL. Callable should NOT depend on the order of being called.
+     */
+    template <typename F>
+    auto update_f(F f)
+        -> decltype((bool)f(_1d2nd(0), cs, (*d)(0)),
+                    (*d)(0) = f(_1d2nd(0), cs, (*d)(0)).value(), void()) {
+        _for_each_index<false>([&](auto& v, const auto& ind, const auto& x) {
+            auto val = f(ind, cs, v);
+            if (val) v = val.value();
+        });
+    }
+
+    /**
+     * @brief Update each element of a field using a callable that takes an
+     * array-like container of *indices*, a pointer to the coordinate system
+     * and a (non-const) reference to the element, and modifies the element in
+     * place.
+     *
+     * Field may be evaluated in PARRALLEL. Callable should NOT depend on the
+     * order of being called.
+     */
+    template <typename F>
+    auto update_f(F f) -> typename std::enable_if<
+        std::is_void<decltype(f(_1d2nd(0), cs, (*d)(0)))>::value>::type {
+        _for_each_index<false>(
+            [&](auto& v, const auto& ind, const auto& x) { f(ind, cs, v); });
+    }
+
+    /**
+     * @brief Set the elements of a field in blocks, using a callable that takes
+     * the *coordinates* of a block of elements and writes their values.
+     *
+     * The field is split into blocks of consecutive (row-major) elements, and
+     * the callable is called once for each block, with the coordinates of the
+     * block stored as a structure-of-arrays. This allows the callable to be
+     * vectorized (or to call a vector math library), which is not possible
+     * when it is called for each element. Blocks may be evaluated in
+     * PARRALLEL. Callable should NOT depend on the order of being called.
+     *
+     * @param f a callable object that accepts two arguments, an array of
+     * NUMDIMS Span<const COORD> and a Span<QUANT>.
+     *
+     * The k'th element of the block has coordinates x[0][k], x[1][k], ..., and
+     * its value should be written to out[k].
+     *
+     * @code
+     * Field<double,2> F(100,200);
+     * ...
+     * F.set_f_batched([](const auto& x, auto out) {
+     *   for (size_t k = 0; k < out.size(); ++k)
+     *     out[k] = exp(-x[0][k] * x[0][k] - x[1][k] * x[1][k]);
+     * });
+     * @endcode
+     */
+    template <typename F>
+    void set_f_batched(F f) {
+        _detach_data();
+        auto p = detail::contiguous_data(*d);
+        // buffers for the coordinates of a block (and the values, for views),
+        // allocated by each thread for its first block.
+        struct Scratch {
+            std::vector<COORD> x;
+            std::vector<QUANT> out;
+        };
+        const auto N = d->num_elements();
+        auto init = [] { return Scratch(); };
+        detail::for_each_block(N, init, [&](Scratch& s, size_t b, size_t e) {
+            const size_t n = e - b;
+            if (s.x.size() < NUMDIMS * n) s.x.resize(NUMDIMS * n);
+            std::array<Span<const COORD>, NUMDIMS> x;
+            // the fastest axis is copied in runs of consecutive axis values,
+            // the coordinate along the other axes only changes every stride
+            // elements, so they are filled in runs of a single value.
+            size_t stride = 1;
+            for (size_t j = NUMDIMS; j-- > 0;) {
+                const auto& axis = static_cast<const cs_type&>(*cs).getAxis(j);
+                const auto a = detail::contiguous_data(axis);
+                const size_t len = d->shape()[j];
+                COORD* xj = s.x.data() + j * n;
+                size_t idx = (b / stride) % len;
+                size_t off = b % stride;
+                for (size_t k = 0; k < n;) {
+                    if (stride == 1) {
+                        const size_t run = std::min(len - idx, n - k);
+                        if (a)
+                            std::copy(a + idx, a + idx + run, xj + k);
+                        else
+                            for (size_t r = 0; r < run; ++r)
+                                xj[k + r] = axis[idx + r];
+                        k += run;
+                        idx = 0;
+                    } else {
+                        const size_t run = std::min(stride - off, n - k);
+                        std::fill(xj + k, xj + k + run, axis[idx]);
+                        k += run;
+                        off = 0;
+                        if (++idx == len) idx = 0;
+                    }
+                }
+                x[j] = Span<const COORD>(xj, n);
+                stride *= len;
+            }
+
+            if (p) {
+                f(x, Span<QUANT>(p + b, n));
+            } else {
+                // views are not contiguous, so write to a buffer first
+                if (s.out.size() < n) s.out.resize(n);
+                f(x, Span<QUANT>(s.out.data(), n));
+                this->template _walk<false>(
+                    b, e, [&](size_t i, const auto& ind, const auto& c) {
+                        (*d)(ind) = s.out[i - b];
+                    });
+            }
+        });
+    }
+
+    /**
+     * @brief Apply a stencil kernel to each element of the field, writing the
+     * results to a second field.
+     *
+     * The kernel is called with the Neighborhood of an element, which gives
+     * the elements at offsets from it, its index, and their coordinates, and
+     * returns the element's new value. The kernel may only read neighbors
+     * within radius of the element (along each axis). Elements are evaluated
+     * in PARRALLEL, in cache sized tiles.
+     *
+     * @param out the field to write to. It is allocated (with a copy of the
+     * coordinate system) if it does not have the same shape, and cannot share
+     * elements with the field.
+     * @param radius the largest offset read by the kernel.
+     * @param kernel a callable object that accepts a Neighborhood and returns
+     * a value.
+     * @param bc the treatment of elements within radius of the boundary (see
+     * StencilBoundary).
+     *
+     * @code
+     * Field<double,2> T(100,100), T2;
+     * ...
+     * T.apply_stencil(T2, 1, [&](const auto& n) {
+     *   return n(0, 0) + a * (n(-1, 0) + n(1, 0) + n(0, -1) + n(0, 1) -
+     *                         4 * n(0, 0));
+     * });
+     * @endcode
+     */
+    template <typename K>
+    void apply_stencil(Field& out, size_t radius, K kernel,
+                       StencilBoundary bc = StencilBoundary::Fixed) const {
+        BOOST_ASSERT(&out != this);
+        if (!out.d || !std::equal(d->shape(), d->shape() + NUMDIMS,
+                                  out.d->shape()))
+            out._reset_like(*this, std::is_constructible<array_type,
+                                                         std::vector<size_t>>());
+        out._detach_data();
+        BOOST_ASSERT(out.d->origin() != d->origin());
+        const auto& ccs = static_cast<const cs_type&>(*cs);
+        detail::StencilGrid<QUANT, COORD, NUMDIMS> g;
+        std::array<std::ptrdiff_t, NUMDIMS> ostride;
+        g.origin = d->origin();
+        for (size_t k = 0; k < NUMDIMS; ++k) {
+            g.stride[k] = d->strides()[k];
+            g.shape[k] = d->shape()[k];
+            g.axis[k] = ccs.getAxis(k).origin();
+            g.axis_stride[k] = ccs.getAxis(k).strides()[0];
+            ostride[k] = out.d->strides()[k];
+        }
+        g.bc = bc;
+        g.radius = radius;
+        detail::apply_stencil(g, out.d->origin(), ostride, kernel);
+    }
+
+    /**
+     * @brief Apply a stencil kernel to the field steps times, for example to
+     * take the time steps of an explicit solver (see apply_stencil()).
+     *
+     * The field is double buffered: each step reads the elements written by
+     * the previous step and writes to a second buffer, and the buffers are
+     * swapped (without copying elements) after each step. After an odd number
+     * of steps, the result is copied back into the field's elements, so
+     * slices of the field (and pointers to its elements) stay valid. The field
+     * must own its elements, i.e. it cannot be a slice.
+     */
+    template <typename K>
+    void iterate_stencil(size_t steps, size_t radius, K kernel,
+                         StencilBoundary bc = StencilBoundary::Fixed) {
+        BOOST_STATIC_ASSERT_MSG(
+            (std::is_constructible<array_type, std::vector<size_t>>::value),
+            "iterate_stencil cannot be called on a field view (slice).");
+        _detach_data();
+        Field buf;
+        for (size_t s = 0; s < steps; ++s) {
+            apply_stencil(buf, radius, kernel, bc);
+            d.swap(buf.d);
+        }
+        if (steps % 2) {
+            d.swap(buf.d);
+            _apply_field(buf, [](auto& x, const auto& y) { x = y; });
         }
     }
 
@@ -561,12 +1683,229 @@ class Field {
      */
     template <typename Q>
     auto set(Q q) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) = std::move(q);
+        _apply_scalar(q, [](auto& x, const auto& v) { x = v; });
+    }
+
+    // reductions
+
+    /**
+     * @brief Location and value of the smallest (or largest) element of the
+     * field. See argmin() and argmax().
+     */
+    struct Extremum {
+        QUANT value;
+        std::array<size_t, NUMDIMS> index;
+        std::array<COORD, NUMDIMS> coord;
+    };
+
+    /**
+     * @brief Return the sum of the elements of the field.
+     *
+     * The sum is computed in parallel using OpenMP. Each block of elements is
+     * summed pairwise. With ReductionMode::Reproducible, the result is
+     * bitwise identical for any number of threads (see ReductionMode).
+     */
+    QUANT sum(ReductionMode mode = ReductionMode::Fast) const {
+        return _reduce(
+            QUANT(),
+            [](size_t, const QUANT* x, size_t n) {
+                return detail::pairwise_sum<QUANT>(
+                    0, n, [x](size_t i) { return x[i]; });
+            },
+            [](const QUANT& a, const QUANT& b) { return a + b; }, mode);
+    }
+
+    /**
+     * @brief Return the smallest (largest) element, with its index and
+     * coordinate. Ties go to the element with the lowest (row-major) index.
+     */
+    Extremum argmin() const {
+        return _extremum([](const QUANT& a, const QUANT& b) { return a < b; });
+    }
+    Extremum argmax() const {
+        return _extremum([](const QUANT& a, const QUANT& b) { return b < a; });
+    }
+
+    /** @brief Return the value of the smallest (largest) element. */
+    QUANT min() const { return argmin().value; }
+    QUANT max() const { return argmax().value; }
+
+    /**
+     * @brief Return the L1 (sum of absolute values), L2 (square root of the
+     * sum of squares), or L-infinity (largest absolute value) norm of the
+     * elements. See sum() for the meaning of mode.
+     */
+    auto norm1(ReductionMode mode = ReductionMode::Fast) const {
+        typedef decltype(std::abs(std::declval<QUANT>())) R;
+        return _reduce(
+            R(),
+            [](size_t, const QUANT* x, size_t n) {
+                return detail::pairwise_sum<R>(
+                    0, n, [x](size_t i) { return std::abs(x[i]); });
+            },
+            [](const R& a, const R& b) { return a + b; }, mode);
+    }
+    auto norm2(ReductionMode mode = ReductionMode::Fast) const {
+        typedef decltype(std::abs(std::declval<QUANT>())) R;
+        return std::sqrt(_reduce(
+            R(),
+            [](size_t, const QUANT* x, size_t n) {
+                return detail::pairwise_sum<R>(0, n, [x](size_t i) {
+                    const R a = std::abs(x[i]);
+                    return a * a;
+                });
+            },
+            [](const R& a, const R& b) { return a + b; }, mode));
+    }
+    auto normInf() const {
+        typedef decltype(std::abs(std::declval<QUANT>())) R;
+        return _reduce(
+            R(),
+            [](size_t, const QUANT* x, size_t n) {
+                R m = R();
+                for (size_t i = 0; i < n; ++i)
+                    m = std::max(m, R(std::abs(x[i])));
+                return m;
+            },
+            [](const R& a, const R& b) { return std::max(a, b); },
+            ReductionMode::Fast);
+    }
+
+    /**
+     * @brief Return the sum of the products of the elements of this field and
+     * f, which must have the same shape. See sum() for the meaning of mode.
+     */
+    auto dot(const Field& f, ReductionMode mode = ReductionMode::Fast) const {
+        BOOST_ASSERT(f.size() == this->size());
+        typedef decltype(std::declval<QUANT>() * std::declval<QUANT>()) R;
+        return _reduce(
+            R(),
+            [&](size_t b, const QUANT* x, size_t n) {
+                std::vector<QUANT> buf;
+                const QUANT* y = f._block_data(b, b + n, buf);
+                return detail::pairwise_sum<R>(
+                    0, n, [x, y](size_t i) { return x[i] * y[i]; });
+            },
+            [](const R& a, const R& b) { return a + b; }, mode);
+    }
+
+    /**
+     * @brief Reduce the field along its k'th axis.
+     *
+     * @param k the axis to reduce.
+     * @param op the reduction: the sum, mean, min, or max of the elements
+     * along the axis, or their integral over the axis coordinates (trapezoid
+     * rule, see AxisReduction).
+     * @return a field with one less dimension, whose coordinate system is a
+     * copy of this one without the k'th axis. It uses the same array types as
+     * the field, if they own their elements, or the default ones (i.e. for
+     * slices, and fields with fixed extents).
+     *
+     * The result is computed in PARALLEL over its elements. Each thread
+     * streams the rows of the field along the reduced axis into a block of
+     * the result, so the field is read in order.
+     *
+     * @code
+     * Field<double,3> rho(100,100,400);
+     * ...
+     * // column density in the x-y plane
+     * auto N = rho.reduce_axis(2, AxisReduction::Integral);
+     * @endcode
+     */
+    auto reduce_axis(size_t k, AxisReduction op) const {
+        BOOST_ASSERT(k < NUMDIMS);
+        typedef typename std::conditional<
+            IsOwningArray<ARRAYND, QUANT, NUMDIMS - 1>::value,
+            Field<QUANT, NUMDIMS - 1, COORD, ARRAYND, ARRAY1D>,
+            Field<QUANT, NUMDIMS - 1, COORD>>::type R;
+        R r(std::make_shared<typename R::cs_type>(
+            static_cast<const cs_type&>(*cs)
+                .template drop_axis<typename R::cs_type>(k)));
+
+        // the field is indexed as [outer][len][inner]
+        auto shape = d->shape();
+        const size_t len = shape[k];
+        size_t outer = 1, inner = 1;
+        for (size_t j = 0; j < k; ++j) outer *= shape[j];
+        for (size_t j = k + 1; j < NUMDIMS; ++j) inner *= shape[j];
+        BOOST_ASSERT(len > 0 || op == AxisReduction::Sum ||
+                     op == AxisReduction::Integral);
+
+        const QUANT* p = detail::contiguous_data(*d);
+        std::vector<QUANT> buf;
+        if (!p) {
+            buf.resize(d->num_elements());
+            detail::for_each_block(buf.size(), [&](size_t b, size_t e) {
+                this->template _walk<false>(
+                    b, e, [&](size_t i, const auto& ind, const auto&) {
+                        buf[i] = (*d)(ind);
+                    });
+            });
+            p = buf.data();
+        }
+
+        // trapezoid weights
+        std::vector<double> w(len, 0.);
+        const auto& a = static_cast<const cs_type&>(*cs).getAxis(k);
+        for (size_t i = 0; i + 1 < len; ++i) {
+            const double h = 0.5 * (a[i + 1] - a[i]);
+            w[i] += h;
+            w[i + 1] += h;
         }
+
+        QUANT* q = r.data();
+        detail::for_each_block(outer * inner, [&](size_t b, size_t e) {
+            while (b < e) {
+                // reduce the n elements of the result at b. if the reduced
+                // axis is not the last one, these are (part of) a row of the
+                // result, and each row of the axis is contiguous. otherwise,
+                // a few independent sums are interleaved.
+                const size_t o = b / inner, j = b % inner;
+                const size_t n = inner > 1 ? std::min(inner - j, e - b)
+                                           : std::min<size_t>(8, e - b);
+                const size_t stride = inner > 1 ? inner : 1;
+                const size_t jstride = inner > 1 ? 1 : len;
+                const QUANT* src = p + o * len * inner + j;
+                QUANT* dst = q + b;
+                switch (op) {
+                    case AxisReduction::Sum:
+                    case AxisReduction::Mean:
+                        _reduce_rows(
+                            src, stride, jstride, len, dst, n,
+                            [](const QUANT& x) { return x; },
+                            [](QUANT& y, const QUANT& x, size_t) { y += x; });
+                        if (op == AxisReduction::Mean)
+                            for (size_t i = 0; i < n; ++i) dst[i] /= len;
+                        break;
+                    case AxisReduction::Min:
+                        _reduce_rows(
+                            src, stride, jstride, len, dst, n,
+                            [](const QUANT& x) { return x; },
+                            [](QUANT& y, const QUANT& x, size_t) {
+                                if (x < y) y = x;
+                            });
+                        break;
+                    case AxisReduction::Max:
+                        _reduce_rows(
+                            src, stride, jstride, len, dst, n,
+                            [](const QUANT& x) { return x; },
+                            [](QUANT& y, const QUANT& x, size_t) {
+                                if (y < x) y = x;
+                            });
+                        break;
+                    case AxisReduction::Integral:
+                        _reduce_rows(
+                            src, stride, jstride, len, dst, n,
+                            [&](const QUANT& x) { return w[0] * x; },
+                            [&](QUANT& y, const QUANT& x, size_t i) {
+                                y += w[i] * x;
+                            });
+                        break;
+                }
+                b += n;
+            }
+        });
+        return r;
     }
 
     // operator overloads
@@ -581,7 +1920,7 @@ class Field {
                 if (ind[j] < last_ind[j]) output << "\n";
 
             for (size_t j = 0; j < NUMDIMS; ++j)
-                output << F.cs->getAxis(j)[ind[j]] << " ";
+                output << F.getAxis(j)[ind[j]] << " ";
             output << F.d->operator()(ind) << "\n";
 
             last_ind = ind;
@@ -594,14 +1933,10 @@ class Field {
      *
      * Field elements are set in parallel using OpenMP.
      */
-    template <typename Q>
+    template <typename Q, typename std::enable_if<!IsFieldExpression<Q>::value,
+                                                  int>::type = 0>
     Field& operator=(const Q& q) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) = q;
-        }
+        _apply_scalar(q, [](auto& x, const auto& v) { x = v; });
         return *this;
     }
 
@@ -611,14 +1946,10 @@ class Field {
      *
      * Field elements are updated in parallel using OpenMP.
      */
-    template <typename Q>
+    template <typename Q, typename std::enable_if<!IsFieldExpression<Q>::value,
+                                                  int>::type = 0>
     Field& operator+=(const Q& q) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) += q;
-        }
+        _apply_scalar(q, [](auto& x, const auto& v) { x += v; });
         return *this;
     }
 
@@ -628,14 +1959,10 @@ class Field {
      *
      * Field elements are updated in parallel using OpenMP.
      */
-    template <typename Q>
+    template <typename Q, typename std::enable_if<!IsFieldExpression<Q>::value,
+                                                  int>::type = 0>
     Field& operator-=(const Q& q) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) -= q;
-        }
+        _apply_scalar(q, [](auto& x, const auto& v) { x -= v; });
         return *this;
     }
 
@@ -645,14 +1972,10 @@ class Field {
      *
      * Field elements are updated in parallel using OpenMP.
      */
-    template <typename Q>
+    template <typename Q, typename std::enable_if<!IsFieldExpression<Q>::value,
+                                                  int>::type = 0>
     Field& operator*=(const Q& q) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) *= q;
-        }
+        _apply_scalar(q, [](auto& x, const auto& v) { x *= v; });
         return *this;
     }
 
@@ -662,21 +1985,36 @@ class Field {
      *
      * Field elements are updated in parallel using OpenMP.
      */
-    template <typename Q>
+    template <typename Q, typename std::enable_if<!IsFieldExpression<Q>::value,
+                                                  int>::type = 0>
     Field& operator/=(const Q& q) {
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) /= q;
-        }
+        _apply_scalar(q, [](auto& x, const auto& v) { x /= v; });
         return *this;
     }
 
+    /**
+     * @brief Assign a field.
+     *
+     * The field takes the elements and coordinate system of (the copy of) f.
+     * A field that refers to elements it does not own (i.e. a slice, or a
+     * MultiField component) copies the elements of f into them instead, if f
+     * is the same shape, and keeps its coordinate system.
+     */
     Field& operator=(Field f) {
+        _assign(f, std::is_constructible<array_type, std::vector<size_t>>());
+        return *this;
+    }
+
+    /**
+     * @brief Swap the elements, coordinate system and copy-on-write setting
+     * of two fields. No elements are copied.
+     */
+    void swap(Field& f) {
         d.swap(f.d);
         cs.swap(f.cs);
-        return *this;
+        std::swap(cow, f.cow);
+        d_owners.swap(f.d_owners);
+        cs_owners.swap(f.cs_owners);
     }
 
     /**
@@ -688,13 +2026,7 @@ class Field {
      * Fields must be of the size.
      */
     Field& operator+=(const Field& f) {
-        BOOST_ASSERT(f.size() == this->size());
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) += f(ind);
-        }
+        _apply_field(f, [](auto& x, const auto& y) { x += y; });
         return *this;
     }
 
@@ -708,13 +2040,7 @@ class Field {
      * Fields must be of the size.
      */
     Field& operator-=(const Field& f) {
-        BOOST_ASSERT(f.size() == this->size());
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) -= f(ind);
-        }
+        _apply_field(f, [](auto& x, const auto& y) { x -= y; });
         return *this;
     }
 
@@ -728,13 +2054,7 @@ class Field {
      * Fields must be of the size.
      */
     Field& operator*=(const Field& f) {
-        BOOST_ASSERT(f.size() == this->size());
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) *= f(ind);
-        }
+        _apply_field(f, [](auto& x, const auto& y) { x *= y; });
         return *this;
     }
 
@@ -748,15 +2068,103 @@ class Field {
      * Fields must be of the size.
      */
     Field& operator/=(const Field& f) {
-        BOOST_ASSERT(f.size() == this->size());
-        auto N = d->num_elements();
-#pragma omp parallel for
-        for (size_t i = 0; i < N; ++i) {
-            auto ind = this->_1d2nd(i);
-            d->operator()(ind) /= f(ind);
-        }
+        _apply_field(f, [](auto& x, const auto& y) { x /= y; });
+        return *this;
+    }
+
+    /**
+     * @brief Set the elements of a field to the value of a field expression.
+     * @param expr an expression built from fields and scalars (see
+     * Expressions.hpp).
+     *
+     * The expression is evaluated in a single pass, in parallel using OpenMP,
+     * without creating temporary fields. If the field is empty, it is
+     * allocated with a copy of the coordinate system of the left-most field in
+     * the expression. Otherwise, the expression must be the same shape as the
+     * field.
+     */
+    template <typename E, typename std::enable_if<IsFieldExpression<E>::value,
+                                                  int>::type = 0>
+    Field& operator=(const E& expr) {
+        if (!d)
+            _reset_like(expr, std::is_constructible<array_type,
+                                                    std::vector<size_t>>());
+        _apply_expression(expr, [](auto& x, const auto& y) { x = y; });
+        return *this;
+    }
+
+    /**
+     * @brief Add the value of a field expression to each element in the field.
+     *
+     * The expression is evaluated in a single pass, in parallel using OpenMP.
+     */
+    template <typename E, typename std::enable_if<IsFieldExpression<E>::value,
+                                                  int>::type = 0>
+    Field& operator+=(const E& expr) {
+        _apply_expression(expr, [](auto& x, const auto& y) { x += y; });
+        return *this;
+    }
+
+    /**
+     * @brief Subtract the value of a field expression from each element in the
+     * field.
+     *
+     * The expression is evaluated in a single pass, in parallel using OpenMP.
+     */
+    template <typename E, typename std::enable_if<IsFieldExpression<E>::value,
+                                                  int>::type = 0>
+    Field& operator-=(const E& expr) {
+        _apply_expression(expr, [](auto& x, const auto& y) { x -= y; });
+        return *this;
+    }
+
+    /**
+     * @brief Multiply each element in the field by the value of a field
+     * expression.
+     *
+     * The expression is evaluated in a single pass, in parallel using OpenMP.
+     */
+    template <typename E, typename std::enable_if<IsFieldExpression<E>::value,
+                                                  int>::type = 0>
+    Field& operator*=(const E& expr) {
+        _apply_expression(expr, [](auto& x, const auto& y) { x *= y; });
+        return *this;
+    }
+
+    /**
+     * @brief Divide each element in the field by the value of a field
+     * expression.
+     *
+     * The expression is evaluated in a single pass, in parallel using OpenMP.
+     */
+    template <typename E, typename std::enable_if<IsFieldExpression<E>::value,
+                                                  int>::type = 0>
+    Field& operator/=(const E& expr) {
+        _apply_expression(expr, [](auto& x, const auto& y) { x /= y; });
         return *this;
     }
 };
 
+template <typename QUANT, size_t NUMDIMS, typename COORD,
+          template <typename, size_t> class ARRAYND,
+          template <typename> class ARRAY1D>
+struct IsField<Field<QUANT, NUMDIMS, COORD, ARRAYND, ARRAY1D>>
+    : std::true_type {};
+
+/**
+ * @brief Return the sum of the products of the elements of two fields (see
+ * Field::dot()).
+ */
+template <typename QUANT, size_t NUMDIMS, typename COORD,
+          template <typename, size_t> class ARRAYND,
+          template <typename> class ARRAY1D>
+auto dot(const Field<QUANT, NUMDIMS, COORD, ARRAYND, ARRAY1D>& a,
+         const Field<QUANT, NUMDIMS, COORD, ARRAYND, ARRAY1D>& b,
+         ReductionMode mode = ReductionMode::Fast) {
+    return a.dot(b, mode);
+}
+
+#include "Differentiation.hpp"
+#include "MultiField.hpp"
+
 #endif
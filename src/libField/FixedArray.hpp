@@ -0,0 +1,204 @@
+#ifndef FixedArray_hpp
+#define FixedArray_hpp
+
+/** @file FixedArray.hpp
+ * @brief Arrays with compile time extents and inline storage, for small fixed
+ * grids (lookup tables, stencil kernels, ...).
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * FixedArray<T, E...> stores its elements in a std::array, and is a
+ * boost::multi_array_ref to them, so it can be used anywhere a multi_array
+ * is. Element access through operator() uses strides that are compile time
+ * constants, and num_elements() is a constant, so loops over small fields
+ * can be fully unrolled and vectorized.
+ *
+ * FixedExtents<E...> provides the template aliases to plug fixed arrays into
+ * a Field (and its CoordinateSystem). Axes are stored inline too, with room
+ * for the longest axis.
+ *
+ * @code
+ * typedef FixedExtents<64, 64> E;
+ * Field<double, 2, double, E::arrayND, E::array1D> table(64, 64);
+ * @endcode
+ */
+
+#include <array>
+#include <boost/assert.hpp>
+#include <boost/multi_array.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+constexpr size_t product() { return 1; }
+template <typename... S>
+constexpr size_t product(size_t e, S... s) {
+    return e * product(s...);
+}
+
+constexpr size_t max_of() { return 0; }
+template <typename... S>
+constexpr size_t max_of(size_t e, S... s) {
+    return e > max_of(s...) ? e : max_of(s...);
+}
+
+/**
+ * The elements of a fixed array. A base class of the array, so that the
+ * elements exist before the multi_array_ref that refers to them.
+ */
+template <typename T, size_t P>
+struct FixedStorage {
+    std::array<T, P> elements{};
+};
+}  // namespace detail
+
+/**
+ * A row-major N-d array with extents E... and inline storage.
+ */
+template <typename T, size_t... E>
+class FixedArray : private detail::FixedStorage<T, detail::product(E...)>,
+                   public boost::multi_array_ref<T, sizeof...(E)> {
+    static constexpr size_t N = sizeof...(E);
+    static constexpr size_t P = detail::product(E...);
+    typedef detail::FixedStorage<T, P> storage_type;
+    typedef boost::multi_array_ref<T, N> base;
+
+    static constexpr size_t _stride(size_t k) {
+        const size_t e[] = {E...};
+        size_t s = 1;
+        for (size_t j = k + 1; j < N; ++j) s *= e[j];
+        return s;
+    }
+
+    template <typename IndexList, size_t... K>
+    static size_t _offset(const IndexList& ind, std::index_sequence<K...>) {
+        size_t o = 0;
+        (void)std::initializer_list<int>{
+            (o += static_cast<size_t>(ind[K]) *
+                  std::integral_constant<size_t, _stride(K)>::value,
+             0)...};
+        return o;
+    }
+
+    template <typename S>
+    static bool _matches(const S& sizes) {
+        const size_t e[] = {E...};
+        for (size_t k = 0; k < N; ++k)
+            if (static_cast<size_t>(sizes[k]) != e[k]) return false;
+        return true;
+    }
+
+   public:
+    FixedArray()
+        : base(this->elements.data(), std::array<size_t, N>{{E...}}) {}
+
+    /**
+     * @brief Create an array with the given sizes, which must be the extents.
+     * (Allows the array to be created like a multi_array.)
+     */
+    template <typename S, typename = typename std::enable_if<
+                              !std::is_base_of<FixedArray, S>::value>::type>
+    explicit FixedArray(const S& sizes) : FixedArray() {
+        BOOST_ASSERT_MSG(_matches(sizes),
+                         "The sizes of a FixedArray must match its extents.");
+    }
+
+    FixedArray(const FixedArray& a)
+        : storage_type(a),
+          base(this->elements.data(), std::array<size_t, N>{{E...}}) {}
+
+    FixedArray& operator=(const FixedArray& a) {
+        this->elements = a.elements;
+        return *this;
+    }
+
+    /**
+     * @brief Return the extent of axis k.
+     */
+    static constexpr size_t extent(size_t k) {
+        const size_t e[] = {E...};
+        return e[k];
+    }
+    constexpr size_t num_elements() const { return P; }
+
+    T* data() { return this->elements.data(); }
+    const T* data() const { return this->elements.data(); }
+    T* origin() { return this->elements.data(); }
+    const T* origin() const { return this->elements.data(); }
+
+    template <typename IndexList>
+    T& operator()(const IndexList& ind) {
+        return this->elements[_offset(ind, std::make_index_sequence<N>())];
+    }
+    template <typename IndexList>
+    const T& operator()(const IndexList& ind) const {
+        return this->elements[_offset(ind, std::make_index_sequence<N>())];
+    }
+
+    /**
+     * @brief The shape of a fixed array cannot change, sizes must be the
+     * extents.
+     */
+    template <typename S>
+    FixedArray& reshape(const S& sizes) {
+        BOOST_ASSERT_MSG(_matches(sizes),
+                         "The sizes of a FixedArray must match its extents.");
+        return *this;
+    }
+};
+
+/**
+ * A 1-d array with inline storage for up to CAP elements. Its size is set
+ * when it is created.
+ */
+template <typename T, size_t CAP>
+class FixedCapacityArray1D : private detail::FixedStorage<T, CAP>,
+                             public boost::multi_array_ref<T, 1> {
+    typedef detail::FixedStorage<T, CAP> storage_type;
+    typedef boost::multi_array_ref<T, 1> base;
+
+   public:
+    FixedCapacityArray1D() : base(this->elements.data(), boost::extents[0]) {}
+
+    /**
+     * @brief Create an array with the given extents (e.g. boost::extents[n]).
+     */
+    template <typename S,
+              typename = typename std::enable_if<
+                  !std::is_base_of<FixedCapacityArray1D, S>::value>::type>
+    explicit FixedCapacityArray1D(const S& sizes)
+        : base(this->elements.data(), sizes) {
+        BOOST_ASSERT_MSG(this->num_elements() <= CAP,
+                         "The size of a FixedCapacityArray1D cannot be larger "
+                         "than its capacity.");
+    }
+
+    FixedCapacityArray1D(const FixedCapacityArray1D& a)
+        : storage_type(a),
+          base(this->elements.data(), boost::extents[a.num_elements()]) {}
+
+    FixedCapacityArray1D& operator=(const FixedCapacityArray1D& a) {
+        BOOST_ASSERT(this->num_elements() == a.num_elements());
+        this->elements = a.elements;
+        return *this;
+    }
+
+    T* data() { return this->elements.data(); }
+    const T* data() const { return this->elements.data(); }
+};
+
+/**
+ * The array types for a field with extents E... (see FixedArray.hpp).
+ */
+template <size_t... E>
+struct FixedExtents {
+    template <typename T, size_t N>
+    using arrayND = typename std::enable_if<N == sizeof...(E),
+                                            FixedArray<T, E...>>::type;
+    template <typename T>
+    using array1D = FixedCapacityArray1D<T, detail::max_of(E...)>;
+};
+
+#endif
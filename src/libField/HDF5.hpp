@@ -39,6 +39,12 @@ bool path_exists(const CT& container, std::string group) {
     return H5Lexists(container.getId(), group.c_str(), H5P_DEFAULT);
 }
 
+template <typename M>
+std::string component_dataset_name(const M& m, size_t k) {
+    return m.getName(k).empty() ? "field " + std::to_string(k)
+                                : m.getName(k);
+}
+
 }  // namespace detail
 
 /**
@@ -56,8 +62,9 @@ bool path_exists(const CT& container, std::string group) {
  * "field" will contain the 50 elements of the field.
  *
  */
-template <typename ST, typename FT, size_t N, typename CT>
-auto hdf5write(ST& container, const Field<FT, N, CT>& f)
+template <typename ST, typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+auto hdf5write(ST& container, const Field<FT, N, CT, AN, A1>& f)
     -> decltype(container.createGroup(std::string()), void()) {
     hsize_t dims[N];
     for (size_t i = 0; i < N; ++i) {
@@ -96,17 +103,19 @@ auto hdf5write(ST& container, const Field<FT, N, CT>& f)
  * "field" will contain the 50 elements of the field.
  *
  */
-template <typename FT, size_t N, typename CT>
-void hdf5write(std::string name, const Field<FT, N, CT>& f,
+template <typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+void hdf5write(std::string name, const Field<FT, N, CT, AN, A1>& f,
                decltype(H5F_ACC_TRUNC) acc = H5F_ACC_TRUNC) {
     H5::H5File file(name.c_str(), acc);
     hdf5write(file, f);
     file.close();
 }
 
-template <typename FT, size_t N, typename CT>
+template <typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
 void hdf5write(std::string name, std::vector<std::string> path,
-               const Field<FT, N, CT>& f,
+               const Field<FT, N, CT, AN, A1>& f,
                decltype(H5F_ACC_TRUNC) acc = H5F_ACC_RDWR) {
     H5::H5File file(name.c_str(), acc);
     H5::Group group = file.openGroup("/");
@@ -136,8 +145,10 @@ void hdf5write(std::string name, std::vector<std::string> path,
  * "field" will contain the 50 elements of the field.
  *
  */
-template <typename FT, size_t N, typename CT>
-void hdf5write(std::string name, std::string path, const Field<FT, N, CT>& f,
+template <typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+void hdf5write(std::string name, std::string path,
+               const Field<FT, N, CT, AN, A1>& f,
                decltype(H5F_ACC_TRUNC) acc = H5F_ACC_TRUNC) {
     auto is_slash = [](char c) { return c == '/'; };
     boost::trim_if(path, is_slash);
@@ -146,6 +157,51 @@ void hdf5write(std::string name, std::string path, const Field<FT, N, CT>& f,
     hdf5write(name, elems, f, acc);
 }
 
+/**
+ * Writes a multi-field to a hdf5 container, which may be a file or group.
+ *
+ * The axes are written to 'axis {i}' datasets, as for a field, and each
+ * component is written to a dataset named after the component (or
+ * 'field {k}' if it does not have a name).
+ */
+template <typename ST, typename FT, size_t N, size_t K, typename CT>
+auto hdf5write(ST& container, const MultiField<FT, N, K, CT>& m)
+    -> decltype(container.createGroup(std::string()), void()) {
+    hsize_t dims[N];
+    for (size_t i = 0; i < N; ++i) {
+        dims[i] = m.size(i);
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        H5::DataSpace dspace(1, &dims[i]);
+        auto dset = container.createDataSet(
+            ("axis " + std::to_string(i)).c_str(),
+            detail::get_hdf5_dtype_for_type<CT>(), dspace);
+        dset.write(m.getAxis(i).data(), detail::get_hdf5_dtype_for_type<CT>());
+        dset.close();
+    }
+
+    H5::DataSpace dspace(N, dims);
+    for (size_t k = 0; k < K; ++k) {
+        auto dset = container.createDataSet(
+            detail::component_dataset_name(m, k).c_str(),
+            detail::get_hdf5_dtype_for_type<FT>(), dspace);
+        dset.write(m[k].data(), detail::get_hdf5_dtype_for_type<FT>());
+        dset.close();
+    }
+}
+
+/**
+ * Writes a multi-field to a file using the HDF5 format (see above).
+ */
+template <typename FT, size_t N, size_t K, typename CT>
+void hdf5write(std::string name, const MultiField<FT, N, K, CT>& m,
+               decltype(H5F_ACC_TRUNC) acc = H5F_ACC_TRUNC) {
+    H5::H5File file(name.c_str(), acc);
+    hdf5write(file, m);
+    file.close();
+}
+
 /*
  * Reads an HDF5 dataset into a field. The dataset is assumed to be an N-D array
  * and is read directly into the field data. Coordinates are set to integer
@@ -154,8 +210,9 @@ void hdf5write(std::string name, std::string path, const Field<FT, N, CT>& f,
  * This function is useful for reading data written by some other application
  * into a field.
  */
-template <typename FT, size_t N, typename CT>
-void hdf5read(H5::DataSet& dset, Field<FT, N, CT>& f) {
+template <typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+void hdf5read(H5::DataSet& dset, Field<FT, N, CT, AN, A1>& f) {
     auto dspace = dset.getSpace();
     if (dspace.getSimpleExtentNdims() != N)
         throw std::runtime_error(
@@ -170,7 +227,7 @@ void hdf5read(H5::DataSet& dset, Field<FT, N, CT>& f) {
     std::array<size_t, N> dims;
     for (size_t i = 0; i < N; ++i) dims[i] = ddims[i];
 
-    f = Field<FT, N, CT>(dims);
+    f.reset(dims);
 
     dset.read(f.data(), detail::get_hdf5_dtype_for_type<FT>());
 
@@ -188,8 +245,9 @@ void hdf5read(H5::DataSet& dset, Field<FT, N, CT>& f) {
  * @param container  the HDF5 container (file or group) to read from.
  * @param f the field to read data into.
  */
-template <typename ST, typename FT, size_t N, typename CT>
-auto hdf5read(ST& container, Field<FT, N, CT>& f)
+template <typename ST, typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+auto hdf5read(ST& container, Field<FT, N, CT, AN, A1>& f)
     -> decltype(container.createGroup(std::string()), void()) {
     auto dset = container.openDataSet("field");
     auto dspace = dset.getSpace();
@@ -206,7 +264,7 @@ auto hdf5read(ST& container, Field<FT, N, CT>& f)
     std::array<size_t, N> dims;
     for (size_t i = 0; i < N; ++i) dims[i] = ddims[i];
 
-    f = Field<FT, N, CT>(dims);
+    f.reset(dims);
 
     dset.read(f.data(), detail::get_hdf5_dtype_for_type<FT>());
 
@@ -244,9 +302,10 @@ auto hdf5read(ST& container, Field<FT, N, CT>& f)
  * N is the axis index (zero offset), and the field data is read from a dataset
  * named "field".
  */
-template <typename ST, typename FT, size_t N, typename CT>
+template <typename ST, typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
 auto hdf5read(ST& container, const std::vector<std::string>& path,
-              Field<FT, N, CT>& f)
+              Field<FT, N, CT, AN, A1>& f)
     -> decltype(container.createGroup(std::string()), void()) {
     H5::Group group = container.openGroup("/");
     for (auto& elem : path) {
@@ -269,8 +328,9 @@ auto hdf5read(ST& container, const std::vector<std::string>& path,
  * N is the axis index (zero offset), and the field data is read from a dataset
  * named "field".
  */
-template <typename ST, typename FT, size_t N, typename CT>
-auto hdf5read(ST& container, std::string path, Field<FT, N, CT>& f)
+template <typename ST, typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+auto hdf5read(ST& container, std::string path, Field<FT, N, CT, AN, A1>& f)
     -> decltype(container.createGroup(std::string()), void()) {
     auto is_slash = [](char c) { return c == '/'; };
     boost::trim_if(path, is_slash);
@@ -285,8 +345,9 @@ auto hdf5read(ST& container, std::string path, Field<FT, N, CT>& f)
  * This function assumes that the file is structured in the way written by
  * hdf5write.
  */
-template <typename FT, size_t N, typename CT>
-void hdf5read(std::string name, Field<FT, N, CT>& f) {
+template <typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+void hdf5read(std::string name, Field<FT, N, CT, AN, A1>& f) {
     H5::H5File file(name.c_str(), H5F_ACC_RDONLY);
     try {
         hdf5read(file, f);
@@ -304,8 +365,9 @@ void hdf5read(std::string name, Field<FT, N, CT>& f) {
  * This function assumes that the file contains a group (which is specified)
  * that is structured in the way written by hdf5write.
  */
-template <typename FT, size_t N, typename CT>
-void hdf5read(std::string name, std::string path, Field<FT, N, CT>& f) {
+template <typename FT, size_t N, typename CT,
+          template <typename, size_t> class AN, template <typename> class A1>
+void hdf5read(std::string name, std::string path, Field<FT, N, CT, AN, A1>& f) {
     H5::H5File file(name.c_str(), H5F_ACC_RDONLY);
     try {
         hdf5read(file, path, f);
@@ -316,3 +378,64 @@ void hdf5read(std::string name, std::string path, Field<FT, N, CT>& f) {
 
     file.close();
 }
+
+/**
+ * Reads a multi-field from an HDF5 container (either a group, or a file),
+ * structured in the way written by hdf5write. The components are read from
+ * the datasets named after the components of m (or 'field {k}').
+ */
+template <typename ST, typename FT, size_t N, size_t K, typename CT>
+auto hdf5read(ST& container, MultiField<FT, N, K, CT>& m)
+    -> decltype(container.createGroup(std::string()), void()) {
+    std::array<size_t, N> dims;
+    for (size_t i = 0; i < N; ++i) {
+        std::string dsetname{"axis " + std::to_string(i)};
+        auto dset = container.openDataSet(dsetname.c_str());
+        auto dspace = dset.getSpace();
+        if (dspace.getSimpleExtentNdims() != 1)
+            throw std::runtime_error("Cannot read axis data from '" + dsetname +
+                                     "'. It does not contain a 1D array.");
+        hsize_t ddims[1];
+        dspace.getSimpleExtentDims(ddims);
+        dims[i] = ddims[0];
+    }
+    m.reset(dims);
+    for (size_t i = 0; i < N; ++i) {
+        std::string dsetname{"axis " + std::to_string(i)};
+        auto dset = container.openDataSet(dsetname.c_str());
+        dset.read(m.getAxis(i).data(), detail::get_hdf5_dtype_for_type<CT>());
+    }
+
+    for (size_t k = 0; k < K; ++k) {
+        const std::string dsetname = detail::component_dataset_name(m, k);
+        auto dset = container.openDataSet(dsetname.c_str());
+        auto dspace = dset.getSpace();
+        hsize_t ddims[N];
+        if (dspace.getSimpleExtentNdims() != N)
+            throw std::runtime_error("Cannot read component from '" + dsetname +
+                                     "'. Dimensions do not match the field.");
+        dspace.getSimpleExtentDims(ddims);
+        for (size_t i = 0; i < N; ++i)
+            if (ddims[i] != dims[i])
+                throw std::runtime_error(
+                    "Cannot read component from '" + dsetname +
+                    "'. Size does not match the size of the axes.");
+        dset.read(m[k].data(), detail::get_hdf5_dtype_for_type<FT>());
+    }
+}
+
+/**
+ * Reads a multi-field from an HDF5 file (see above).
+ */
+template <typename FT, size_t N, size_t K, typename CT>
+void hdf5read(std::string name, MultiField<FT, N, K, CT>& m) {
+    H5::H5File file(name.c_str(), H5F_ACC_RDONLY);
+    try {
+        hdf5read(file, m);
+    } catch (std::runtime_error& e) {
+        throw std::runtime_error("There was an error reading field from '" +
+                                 name + ". " + e.what());
+    }
+
+    file.close();
+}
@@ -0,0 +1,240 @@
+#ifndef MultiField_hpp
+#define MultiField_hpp
+
+/** @file MultiField.hpp
+ * @brief A set of fields (components) stored in a single block of memory,
+ * over one coordinate system.
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * Multiphysics simulations usually store several quantities (temperature,
+ * density, heat capacity, ...) at the same points. A MultiField stores them as
+ * a structure of arrays: each component is a contiguous array (aligned to 64
+ * bytes), and all components are allocated in one block and share the same
+ * coordinate system.
+ *
+ * @code
+ * MultiField<double,1,4> M(1000);
+ * M.setNames({"T", "rho", "c", "kappa"});
+ * M.setCoordinateSystem(Uniform(0,10));
+ * M["rho"] = 2;
+ * M.for_each([&](double& T, double rho, double c, double kappa) {
+ *   T += dt * kappa / (rho * c);
+ * });
+ * @endcode
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Allocators.hpp"
+#include "Utils.hpp"
+
+template <typename QUANT, size_t NUMDIMS, size_t NCOMP,
+          typename COORD = QUANT>
+class MultiField {
+   public:
+    /** Components are fields that refer to elements in the block. */
+    typedef Field<QUANT, NUMDIMS, COORD, refND> field_type;
+    typedef typename field_type::cs_type cs_type;
+
+   protected:
+    /** The elements of all components, and the arrays referring to them. */
+    struct Block {
+        std::vector<QUANT, allocators::AlignedAllocator<QUANT>> elements;
+        std::vector<refND<QUANT, NUMDIMS>> arrays;
+    };
+
+    std::shared_ptr<cs_type> cs;
+    std::shared_ptr<Block> block;
+    // number of elements from the start of one component to the next. Each
+    // component is padded to a multiple of 64 bytes, so all are aligned.
+    size_t stride = 0;
+    std::array<field_type, NCOMP> comps;
+    std::array<std::string, NCOMP> names;
+
+    template <typename S>
+    void _reallocate(const S& sizes) {
+        size_t n = 1;
+        for (size_t i = 0; i < NUMDIMS; ++i) n *= sizes[i];
+        const size_t pad = std::max<size_t>(1, 64 / sizeof(QUANT));
+        stride = (n + pad - 1) / pad * pad;
+        block = std::make_shared<Block>();
+        block->elements.resize(stride * NCOMP);
+        block->arrays.reserve(NCOMP);
+        for (size_t k = 0; k < NCOMP; ++k) {
+            block->arrays.emplace_back(block->elements.data() + k * stride,
+                                       sizes);
+            // the component arrays keep the block alive
+            field_type c(cs, std::shared_ptr<refND<QUANT, NUMDIMS>>(
+                                 block, &block->arrays[k]));
+            comps[k].swap(c);
+        }
+    }
+
+    template <typename F, size_t... K>
+    void _call(F& f, size_t i, std::index_sequence<K...>) {
+        QUANT* p = block->elements.data() + i;
+        f(p[K * stride]...);
+    }
+
+   public:
+    MultiField() = default;
+    MultiField(MultiField&&) = default;
+    MultiField& operator=(MultiField&& m) {
+        swap(m);
+        return *this;
+    }
+
+    /**
+     * @brief Copy a multi-field. The elements and the coordinate system are
+     * copied.
+     */
+    MultiField(const MultiField& m) : names(m.names) {
+        if (!m.block) return;
+        cs = std::make_shared<cs_type>(*m.cs, typename cs_type::DeepCopy());
+        std::array<size_t, NUMDIMS> sizes;
+        for (size_t i = 0; i < NUMDIMS; ++i) sizes[i] = m.size(i);
+        _reallocate(sizes);
+        std::copy(m.block->elements.begin(), m.block->elements.end(),
+                  block->elements.begin());
+    }
+    MultiField& operator=(const MultiField& m) {
+        MultiField tmp(m);
+        swap(tmp);
+        return *this;
+    }
+
+    /**
+     * @brief Swap two multi-fields. No elements are copied (assigning
+     * components would copy their elements, see Field::operator=()).
+     */
+    void swap(MultiField& m) {
+        cs.swap(m.cs);
+        block.swap(m.block);
+        std::swap(stride, m.stride);
+        for (size_t k = 0; k < NCOMP; ++k) comps[k].swap(m.comps[k]);
+        names.swap(m.names);
+    }
+
+    /**
+     * @brief Create a multi-field, and allocate memory for a grid with the
+     * given sizes.
+     */
+    template <typename... Dims,
+              typename std::enable_if<sizeof...(Dims) == NUMDIMS, int>::type =
+                  0>
+    MultiField(Dims... dims) {
+        reset(dims...);
+    }
+
+    /**
+     * @brief Create a multi-field over an existing coordinate system (which
+     * is shared, not copied).
+     */
+    MultiField(std::shared_ptr<cs_type> cs_) { reset(cs_); }
+
+    /**
+     * @brief Reallocate the multi-field (and a new coordinate system) with
+     * new dimensions. Elements are not preserved.
+     */
+    template <typename... Dims>
+    void reset(Dims... dims) {
+        reset(std::array<size_t, NUMDIMS>{{static_cast<size_t>(dims)...}});
+    }
+    void reset(const std::array<size_t, NUMDIMS>& sizes) {
+        cs = std::make_shared<cs_type>(sizes);
+        _reallocate(sizes);
+    }
+    void reset(std::shared_ptr<cs_type> cs_) {
+        cs = cs_;
+        std::array<size_t, NUMDIMS> sizes;
+        for (size_t i = 0; i < NUMDIMS; ++i) sizes[i] = cs->size(i);
+        _reallocate(sizes);
+    }
+
+    /**
+     * @brief Return the k'th component. Components share the elements (and
+     * coordinate system) of the multi-field, copies of them are views (which
+     * keep the elements alive). Assigning a field to a component copies its
+     * elements.
+     */
+    field_type& operator[](size_t k) { return comps[k]; }
+    const field_type& operator[](size_t k) const { return comps[k]; }
+
+    /**
+     * @brief Return the component with the given name (see setNames()).
+     */
+    field_type& operator[](const std::string& name) {
+        return comps[index(name)];
+    }
+    const field_type& operator[](const std::string& name) const {
+        return comps[index(name)];
+    }
+
+    void setNames(const std::array<std::string, NCOMP>& n) { names = n; }
+    const std::array<std::string, NCOMP>& getNames() const { return names; }
+    const std::string& getName(size_t k) const { return names[k]; }
+
+    /**
+     * @brief Return the index of the component with the given name.
+     */
+    size_t index(const std::string& name) const {
+        for (size_t k = 0; k < NCOMP; ++k)
+            if (names[k] == name) return k;
+        throw std::out_of_range("MultiField has no component named '" + name +
+                                "'.");
+    }
+
+    static constexpr size_t components() { return NCOMP; }
+    auto size() const { return comps[0].size(); }
+    auto size(int i) const { return comps[0].size(i); }
+
+    template <typename... Args>
+    auto setCoordinateSystem(Args... args) {
+        cs->set(args...);
+    }
+    auto& getCoordinateSystem() { return *cs; }
+    const auto& getCoordinateSystem() const { return *cs; }
+    auto getCoordinateSystemPtr() { return cs; }
+    auto& getAxis(size_t i) { return cs->getAxis(i); }
+    const auto& getAxis(size_t i) const {
+        return static_cast<const cs_type&>(*cs).getAxis(i);
+    }
+    template <typename... Args>
+    auto getCoord(Args... args) const {
+        return cs->getCoord(args...);
+    }
+
+    /**
+     * @brief Call f with the elements of every component at each point, in a
+     * single PARRALLEL loop.
+     *
+     * f is called with NCOMP (non-const) references, the element of component
+     * 0, component 1, ... . Callable should NOT depend on the order of being
+     * called.
+     */
+    template <typename F>
+    void for_each(F f) {
+        detail::for_each_block(size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i)
+                _call(f, i, std::make_index_sequence<NCOMP>());
+        });
+    }
+
+    /**
+     * @brief Return a pointer to the block holding all components. Component
+     * k starts at data() + k * component_stride().
+     */
+    QUANT* data() { return block->elements.data(); }
+    const QUANT* data() const { return block->elements.data(); }
+    size_t component_stride() const { return stride; }
+};
+
+#endif
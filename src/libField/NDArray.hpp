@@ -0,0 +1,203 @@
+#ifndef NDArray_hpp
+#define NDArray_hpp
+
+/** @file NDArray.hpp
+ * @brief A row-major N-d array owned by libField, with fast element access.
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * boost::multi_array's element access goes through index bases, a general
+ * storage order, and the sub-array proxies of operator[]. NDArray stores its
+ * elements in a single (64 byte aligned) block in row-major order, with
+ * zero index bases, so an element is base[sum_k i_k * stride_k].
+ *
+ * NDArray is a boost::multi_array_ref to its own elements, so it can be used
+ * wherever a multi_array is (slicing, views, I/O). Use nativeArrayND as the
+ * ARRAYND parameter of Field to store a field in an NDArray.
+ *
+ * @code
+ * Field<double, 3, double, nativeArrayND> T(100, 100, 100);
+ * @endcode
+ *
+ * Indices are checked with BOOST_ASSERT (i.e. unless NDEBUG is defined). Define
+ * LIBFIELD_UNCHECKED_ACCESS to turn the checks off, even when asserts are
+ * enabled.
+ */
+
+#include <algorithm>
+#include <array>
+#include <boost/assert.hpp>
+#include <boost/multi_array.hpp>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Allocators.hpp"
+
+namespace detail {
+/**
+ * The elements of an NDArray. A base class of the array, so that the
+ * elements exist before the multi_array_ref that refers to them.
+ */
+template <typename T, typename Alloc>
+struct NDStorage {
+    std::vector<T, Alloc> elements;
+};
+}  // namespace detail
+
+template <typename T, size_t N,
+          typename Alloc = allocators::AlignedAllocator<T, 64>>
+class NDArray : private detail::NDStorage<T, Alloc>,
+                public boost::multi_array_ref<T, N> {
+    typedef detail::NDStorage<T, Alloc> storage_type;
+    typedef boost::multi_array_ref<T, N> base;
+
+    // the sizes given by a list of sizes, or by boost::extents
+    template <typename S>
+    static std::array<size_t, N> _sizes(const S& s) {
+        std::array<size_t, N> r;
+        std::copy(s.begin(), s.end(), r.begin());
+        return r;
+    }
+    static std::array<size_t, N> _sizes(
+        const boost::detail::multi_array::extent_gen<N>& s) {
+        std::array<size_t, N> r;
+        for (size_t k = 0; k < N; ++k) {
+            BOOST_ASSERT_MSG(s.ranges_[k].start() == 0,
+                             "NDArray index bases are always zero.");
+            r[k] = s.ranges_[k].size();
+        }
+        return r;
+    }
+    static size_t _count(const std::array<size_t, N>& s) {
+        size_t n = 1;
+        for (size_t k = 0; k < N; ++k) n *= s[k];
+        return n;
+    }
+    std::array<size_t, N> _shape() const {
+        std::array<size_t, N> r;
+        std::copy(this->shape(), this->shape() + N, r.begin());
+        return r;
+    }
+
+    template <typename IndexList, size_t... K>
+    size_t _offset(const IndexList& ind, std::index_sequence<K...>) const {
+#ifndef LIBFIELD_UNCHECKED_ACCESS
+        // (a loop, because BOOST_ASSERT cannot be expanded as a pack when it
+        // is disabled by NDEBUG)
+        for (size_t k = 0; k < N; ++k)
+            BOOST_ASSERT(static_cast<size_t>(ind[k]) < this->extent_list_[k]);
+#endif
+        size_t o = 0;
+        (void)std::initializer_list<int>{
+            (o += static_cast<size_t>(ind[K]) * this->stride_list_[K], 0)...};
+        return o;
+    }
+
+   public:
+    typedef Alloc allocator_type;
+
+    NDArray() : base(nullptr, std::array<size_t, N>{}) {}
+
+    /**
+     * @brief Create an array with the given sizes (a list of sizes, or
+     * boost::extents[n0][n1]...). Elements are value initialized.
+     */
+    template <typename S, typename = typename std::enable_if<
+                              !std::is_base_of<NDArray, S>::value>::type>
+    explicit NDArray(const S& sizes)
+        : storage_type{std::vector<T, Alloc>(_count(_sizes(sizes)))},
+          base(this->elements.data(), _sizes(sizes)) {}
+
+    NDArray(const NDArray& a)
+        : storage_type(a), base(this->elements.data(), a._shape()) {}
+
+    NDArray(NDArray&& a)
+        : storage_type(std::move(a)), base(this->elements.data(), a._shape()) {
+        a.resize(std::array<size_t, N>{});
+    }
+
+    NDArray& operator=(const NDArray& a) {
+        if (this != &a) {
+            this->elements = a.elements;
+            this->set_base_ptr(this->elements.data());
+            this->init_multi_array_ref(a._shape().begin());
+        }
+        return *this;
+    }
+
+    NDArray& operator=(NDArray&& a) {
+        this->elements.swap(a.elements);
+        this->set_base_ptr(this->elements.data());
+        this->init_multi_array_ref(a._shape().begin());
+        a.resize(std::array<size_t, N>{});
+        return *this;
+    }
+
+    /**
+     * @brief Change the shape of the array. Unlike multi_array::resize(), the
+     * elements are not preserved (they are value initialized).
+     */
+    template <typename S>
+    NDArray& resize(const S& sizes) {
+        const auto s = _sizes(sizes);
+        std::vector<T, Alloc>(_count(s)).swap(this->elements);
+        this->set_base_ptr(this->elements.data());
+        this->init_multi_array_ref(s.begin());
+        return *this;
+    }
+
+    T* data() { return this->elements.data(); }
+    const T* data() const { return this->elements.data(); }
+    T* origin() { return this->elements.data(); }
+    const T* origin() const { return this->elements.data(); }
+
+    /**
+     * @brief Return the element with the given indices (any array-like
+     * container).
+     */
+    template <typename IndexList, typename = decltype(std::declval<
+                                      const IndexList&>()[0])>
+    T& operator()(const IndexList& ind) {
+        return this->elements[_offset(ind, std::make_index_sequence<N>())];
+    }
+    template <typename IndexList, typename = decltype(std::declval<
+                                      const IndexList&>()[0])>
+    const T& operator()(const IndexList& ind) const {
+        return this->elements[_offset(ind, std::make_index_sequence<N>())];
+    }
+
+    /**
+     * @brief Return the element with indices (i, args...).
+     */
+    template <
+        typename I, typename... Args,
+        typename std::enable_if<std::is_integral<I>::value, int>::type = 0>
+    T& operator()(I i, Args... args) {
+        static_assert(sizeof...(Args) + 1 == N,
+                      "one index is needed for each dimension.");
+        return (*this)(std::array<I, N>{{i, static_cast<I>(args)...}});
+    }
+    template <
+        typename I, typename... Args,
+        typename std::enable_if<std::is_integral<I>::value, int>::type = 0>
+    const T& operator()(I i, Args... args) const {
+        static_assert(sizeof...(Args) + 1 == N,
+                      "one index is needed for each dimension.");
+        return (*this)(std::array<I, N>{{i, static_cast<I>(args)...}});
+    }
+};
+
+namespace allocators {
+template <typename T, size_t N, typename Alloc>
+struct AllocatorOf<NDArray<T, N, Alloc>> {
+    typedef Alloc type;
+};
+}  // namespace allocators
+
+/** N-d array stored in an NDArray (see NDArray.hpp). */
+template <typename T, std::size_t N>
+using nativeArrayND = NDArray<T, N>;
+
+#endif
@@ -0,0 +1,253 @@
+#ifndef Points_hpp
+#define Points_hpp
+
+/** @file Points.hpp
+ * @brief Random access iteration over the points of a field (see
+ * Field::points()).
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * Each point gives the index of an element, its coordinates (read from the
+ * axes when they are asked for), and a reference to the element. The
+ * iterators are random access, so the points can be used with the standard
+ * algorithms (including the parallel ones in C++17).
+ *
+ * @code
+ * Field<double,2> T(100,100);
+ * for (auto p : T.points()) p.value() = p.coord(0) * p.coord(1);
+ *
+ * auto P = T.points();
+ * std::for_each(std::execution::par_unseq, P.begin(), P.end(), [](auto p) {
+ *   auto [ind, x, v] = p;
+ *   v = x[0] * x[1];
+ * });
+ * @endcode
+ */
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+namespace detail {
+/**
+ * The layout of the elements and coordinates of a field. Elements and axes
+ * are addressed with strides, so views are supported.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+struct PointGrid {
+    QUANT* origin;
+    std::array<std::ptrdiff_t, NUMDIMS> stride;
+    std::array<size_t, NUMDIMS> shape;
+    std::array<const COORD*, NUMDIMS> axis;
+    std::array<std::ptrdiff_t, NUMDIMS> axis_stride;
+    size_t size;
+};
+}  // namespace detail
+
+/**
+ * A point of a field: the index of an element, its coordinates, and a
+ * reference to the element. QUANT is const for the points of a const field.
+ *
+ * Points can be unpacked like a tuple (index, coordinates, value
+ * reference), with get<I>() or structured bindings.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+class FieldPoint {
+   public:
+    FieldPoint(const detail::PointGrid<QUANT, COORD, NUMDIMS>& grid,
+               const std::array<size_t, NUMDIMS>& index)
+        : g(&grid), ind(index) {}
+
+    /**
+     * @brief Return the index of the element.
+     */
+    const std::array<size_t, NUMDIMS>& index() const { return ind; }
+
+    /**
+     * @brief Return the coordinate of the element along axis k.
+     */
+    COORD coord(size_t k) const {
+        return g->axis[k][ind[k] * g->axis_stride[k]];
+    }
+
+    /**
+     * @brief Return the coordinates of the element.
+     */
+    std::array<COORD, NUMDIMS> coord() const {
+        std::array<COORD, NUMDIMS> x;
+        for (size_t k = 0; k < NUMDIMS; ++k) x[k] = coord(k);
+        return x;
+    }
+
+    /**
+     * @brief Return a reference to the element.
+     */
+    QUANT& value() const {
+        std::ptrdiff_t s = 0;
+        for (size_t k = 0; k < NUMDIMS; ++k) s += ind[k] * g->stride[k];
+        return g->origin[s];
+    }
+
+    /**
+     * @brief Return the index (I = 0), coordinates (I = 1) or a reference to
+     * the element (I = 2).
+     */
+    template <size_t I>
+    decltype(auto) get() const {
+        return _get(std::integral_constant<size_t, I>());
+    }
+
+   protected:
+    std::array<size_t, NUMDIMS> _get(std::integral_constant<size_t, 0>) const {
+        return ind;
+    }
+    std::array<COORD, NUMDIMS> _get(std::integral_constant<size_t, 1>) const {
+        return coord();
+    }
+    QUANT& _get(std::integral_constant<size_t, 2>) const { return value(); }
+
+    const detail::PointGrid<QUANT, COORD, NUMDIMS>* g;
+    std::array<size_t, NUMDIMS> ind;
+};
+
+namespace std {
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+struct tuple_size<FieldPoint<QUANT, COORD, NUMDIMS>>
+    : std::integral_constant<size_t, 3> {};
+
+template <size_t I, typename QUANT, typename COORD, size_t NUMDIMS>
+struct tuple_element<I, FieldPoint<QUANT, COORD, NUMDIMS>> {
+    typedef decltype(std::declval<FieldPoint<QUANT, COORD, NUMDIMS>>()
+                         .template get<I>()) type;
+};
+}  // namespace std
+
+/**
+ * Random access iterator over the points of a field, in row-major order.
+ * Dereferencing an iterator returns a FieldPoint (by value).
+ *
+ * Iterators refer to the FieldPoints range they came from, which must
+ * outlive them.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+class PointIterator {
+   public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef FieldPoint<QUANT, COORD, NUMDIMS> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef value_type reference;
+    typedef void pointer;
+
+    PointIterator() = default;
+    PointIterator(const detail::PointGrid<QUANT, COORD, NUMDIMS>& grid,
+                  size_t i)
+        : g(&grid) {
+        _seek(i);
+    }
+
+    reference operator*() const { return value_type(*g, ind); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    PointIterator& operator++() {
+        // increment the index, carrying into the slower axes
+        ++i;
+        for (size_t k = NUMDIMS; k-- > 1;) {
+            if (++ind[k] < g->shape[k]) return *this;
+            ind[k] = 0;
+        }
+        ++ind[0];
+        return *this;
+    }
+    PointIterator& operator--() {
+        --i;
+        for (size_t k = NUMDIMS; k-- > 1;) {
+            if (ind[k]-- > 0) return *this;
+            ind[k] = g->shape[k] - 1;
+        }
+        --ind[0];
+        return *this;
+    }
+    PointIterator operator++(int) {
+        PointIterator r(*this);
+        ++*this;
+        return r;
+    }
+    PointIterator operator--(int) {
+        PointIterator r(*this);
+        --*this;
+        return r;
+    }
+    PointIterator& operator+=(difference_type n) {
+        _seek(i + n);
+        return *this;
+    }
+    PointIterator& operator-=(difference_type n) {
+        _seek(i - n);
+        return *this;
+    }
+    PointIterator operator+(difference_type n) const {
+        PointIterator r(*this);
+        return r += n;
+    }
+    friend PointIterator operator+(difference_type n, const PointIterator& it) {
+        return it + n;
+    }
+    PointIterator operator-(difference_type n) const {
+        PointIterator r(*this);
+        return r -= n;
+    }
+    difference_type operator-(const PointIterator& it) const {
+        return static_cast<difference_type>(i) -
+               static_cast<difference_type>(it.i);
+    }
+
+    bool operator==(const PointIterator& it) const { return i == it.i; }
+    bool operator!=(const PointIterator& it) const { return i != it.i; }
+    bool operator<(const PointIterator& it) const { return i < it.i; }
+    bool operator>(const PointIterator& it) const { return i > it.i; }
+    bool operator<=(const PointIterator& it) const { return i <= it.i; }
+    bool operator>=(const PointIterator& it) const { return i >= it.i; }
+
+   protected:
+    // move to the n'th point. The end has the index (shape[0], 0, ...).
+    void _seek(size_t n) {
+        i = n;
+        // an empty field has no points, and may have zero extents
+        if (g->size == 0) return;
+        for (size_t k = NUMDIMS; k-- > 1;) {
+            ind[k] = n % g->shape[k];
+            n /= g->shape[k];
+        }
+        ind[0] = n;
+    }
+
+    const detail::PointGrid<QUANT, COORD, NUMDIMS>* g = nullptr;
+    size_t i = 0;
+    std::array<size_t, NUMDIMS> ind{};
+};
+
+/**
+ * The points of a field, as a random access range (see Field::points()). The
+ * field must outlive the range.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+class FieldPoints {
+   public:
+    typedef PointIterator<QUANT, COORD, NUMDIMS> iterator;
+    typedef FieldPoint<QUANT, COORD, NUMDIMS> value_type;
+
+    explicit FieldPoints(const detail::PointGrid<QUANT, COORD, NUMDIMS>& grid)
+        : g(grid) {}
+
+    iterator begin() const { return iterator(g, 0); }
+    iterator end() const { return iterator(g, g.size); }
+    size_t size() const { return g.size; }
+    value_type operator[](size_t i) const { return begin()[i]; }
+
+   protected:
+    detail::PointGrid<QUANT, COORD, NUMDIMS> g;
+};
+
+#endif
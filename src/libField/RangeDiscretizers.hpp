@@ -23,6 +23,9 @@ class UniformImp {
         return min + i * (1. * max - 1. * min) / (N - 1);
     }
 
+    T getMin() const { return min; }
+    T getMax() const { return max; }
+
    protected:
     T min, max;
 };
@@ -54,6 +57,10 @@ class GeometricImp {
         return min + 1. * dx * (1 - std::pow(1. * stretch, i)) / (1 - stretch);
     }
 
+    T getMin() const { return min; }
+    T getDx() const { return dx; }
+    double getStretch() const { return stretch; }
+
    protected:
     T min, dx;
     double stretch;
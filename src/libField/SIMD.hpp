@@ -0,0 +1,242 @@
+#ifndef SIMD_hpp
+#define SIMD_hpp
+
+/** @file SIMD.hpp
+ * @brief Explicitly vectorized kernels for the element-wise field operators.
+ * @author C.D. Clark III
+ * @date 10/16/26
+ *
+ * The kernels apply an operation op(a[i], b[i]) (or op(a[i], v)) to a
+ * contiguous range of float or double elements. The operation is a generic
+ * callable (i.e. [](auto& x, const auto& y){ x += y; }) that is called with
+ * vector registers for the bulk of the range, and with scalars for the
+ * remainder.
+ *
+ * With GCC and Clang on x86, kernels are compiled for SSE2, AVX2, and
+ * AVX-512, and the widest instruction set supported by the CPU is selected at
+ * runtime, so the library does not need to be compiled with -march=native.
+ * On other platforms (or if LIBFIELD_NO_SIMD is defined) the kernels are
+ * plain loops that are left to the compiler to vectorize.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(LIBFIELD_NO_SIMD) &&                \
+    (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define LIBFIELD_SIMD_X86 1
+#else
+#define LIBFIELD_SIMD_X86 0
+#endif
+
+namespace simd_kernels {
+
+/** True if fields of type T are updated with the vectorized kernels. */
+template <typename T>
+struct IsVectorizable
+    : std::integral_constant<bool, std::is_same<T, float>::value ||
+                                       std::is_same<T, double>::value> {};
+
+/** True if a field of type T can be combined with a scalar of type Q by the
+ * vectorized kernels. The scalar is converted to T first, see is_exact(). */
+template <typename T, typename Q,
+          bool = IsVectorizable<T>::value && std::is_arithmetic<Q>::value>
+struct IsVectorizableScalar : std::false_type {};
+// std::common_type<T,Q> is only instantiated for arithmetic scalars (it is
+// not defined for class types like boost::units::quantity)
+template <typename T, typename Q>
+struct IsVectorizableScalar<T, Q, true>
+    : std::integral_constant<
+          bool, std::is_same<typename std::common_type<T, Q>::type,
+                             T>::value ||
+                    (std::is_same<T, float>::value &&
+                     std::is_same<Q, double>::value)> {};
+
+/**
+ * Return true if computing x op v, where v = T(q), gives the same result as
+ * x op q for every x.
+ *
+ * This is always true if x op q is computed in T. For a float field and a
+ * double scalar, it is true if the scalar is exactly representable as a float,
+ * because a double has enough precision that rounding a float +,-,*,/ to
+ * double and then to float gives the correctly rounded float result.
+ */
+template <typename T, typename Q>
+typename std::enable_if<
+    std::is_same<typename std::common_type<T, Q>::type, T>::value, bool>::type
+is_exact(T v, Q q) {
+    return true;
+}
+template <typename T, typename Q>
+typename std::enable_if<
+    !std::is_same<typename std::common_type<T, Q>::type, T>::value, bool>::type
+is_exact(T v, Q q) {
+    return static_cast<Q>(v) == q;
+}
+
+/** Plain loop versions of the kernels. Used for the remainder of a range, and
+ * when explicit vectorization is not available. */
+template <typename T, typename OP>
+inline void apply_array_scalar(T* a, const T* b, size_t n, OP op) {
+    for (size_t i = 0; i < n; ++i) op(a[i], b[i]);
+}
+
+template <typename T, typename OP>
+inline void apply_value_scalar(T* a, T v, size_t n, OP op) {
+    for (size_t i = 0; i < n; ++i) op(a[i], v);
+}
+
+#if LIBFIELD_SIMD_X86
+
+#define LIBFIELD_ALWAYS_INLINE inline __attribute__((always_inline))
+
+/** Vector type holding W bytes of T. */
+template <typename T, size_t W>
+struct Vec {
+    typedef T type __attribute__((vector_size(W)));
+};
+
+// The kernel bodies are force-inlined into the wrappers below, which are
+// compiled for a specific instruction set. Vector loads and stores go through
+// memcpy, so the pointers do not need to be aligned.
+template <typename V, typename T, typename OP>
+LIBFIELD_ALWAYS_INLINE void apply_array_imp(T* a, const T* b, size_t n,
+                                            OP op) {
+    constexpr size_t W = sizeof(V) / sizeof(T);
+    size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W) {
+        V x0, x1, y0, y1;
+        std::memcpy(&x0, a + i, sizeof(V));
+        std::memcpy(&x1, a + i + W, sizeof(V));
+        std::memcpy(&y0, b + i, sizeof(V));
+        std::memcpy(&y1, b + i + W, sizeof(V));
+        op(x0, y0);
+        op(x1, y1);
+        std::memcpy(a + i, &x0, sizeof(V));
+        std::memcpy(a + i + W, &x1, sizeof(V));
+    }
+    for (; i + W <= n; i += W) {
+        V x, y;
+        std::memcpy(&x, a + i, sizeof(V));
+        std::memcpy(&y, b + i, sizeof(V));
+        op(x, y);
+        std::memcpy(a + i, &x, sizeof(V));
+    }
+    apply_array_scalar(a + i, b + i, n - i, op);
+}
+
+template <typename V, typename T, typename OP>
+LIBFIELD_ALWAYS_INLINE void apply_value_imp(T* a, T v, size_t n, OP op) {
+    constexpr size_t W = sizeof(V) / sizeof(T);
+    const V y = V{} + v;
+    size_t i = 0;
+    for (; i + 2 * W <= n; i += 2 * W) {
+        V x0, x1;
+        std::memcpy(&x0, a + i, sizeof(V));
+        std::memcpy(&x1, a + i + W, sizeof(V));
+        op(x0, y);
+        op(x1, y);
+        std::memcpy(a + i, &x0, sizeof(V));
+        std::memcpy(a + i + W, &x1, sizeof(V));
+    }
+    for (; i + W <= n; i += W) {
+        V x;
+        std::memcpy(&x, a + i, sizeof(V));
+        op(x, y);
+        std::memcpy(a + i, &x, sizeof(V));
+    }
+    apply_value_scalar(a + i, v, n - i, op);
+}
+
+template <typename T, typename OP>
+__attribute__((target("avx512f"))) void apply_array_avx512(T* a, const T* b,
+                                                           size_t n, OP op) {
+    apply_array_imp<typename Vec<T, 64>::type>(a, b, n, op);
+}
+template <typename T, typename OP>
+__attribute__((target("avx2"))) void apply_array_avx2(T* a, const T* b,
+                                                      size_t n, OP op) {
+    apply_array_imp<typename Vec<T, 32>::type>(a, b, n, op);
+}
+template <typename T, typename OP>
+__attribute__((target("sse2"))) void apply_array_sse2(T* a, const T* b,
+                                                      size_t n, OP op) {
+    apply_array_imp<typename Vec<T, 16>::type>(a, b, n, op);
+}
+
+template <typename T, typename OP>
+__attribute__((target("avx512f"))) void apply_value_avx512(T* a, T v,
+                                                           size_t n, OP op) {
+    apply_value_imp<typename Vec<T, 64>::type>(a, v, n, op);
+}
+template <typename T, typename OP>
+__attribute__((target("avx2"))) void apply_value_avx2(T* a, T v, size_t n,
+                                                      OP op) {
+    apply_value_imp<typename Vec<T, 32>::type>(a, v, n, op);
+}
+template <typename T, typename OP>
+__attribute__((target("sse2"))) void apply_value_sse2(T* a, T v, size_t n,
+                                                      OP op) {
+    apply_value_imp<typename Vec<T, 16>::type>(a, v, n, op);
+}
+
+#undef LIBFIELD_ALWAYS_INLINE
+
+enum class ISA { SSE2, AVX2, AVX512 };
+
+/** Return the widest instruction set supported by the CPU. Detected once. */
+inline ISA isa() {
+    static const ISA level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return ISA::AVX512;
+        if (__builtin_cpu_supports("avx2")) return ISA::AVX2;
+        return ISA::SSE2;
+    }();
+    return level;
+}
+
+/** Compute op(a[i], b[i]) for i in [0,n). */
+template <typename T, typename OP>
+void apply_array(T* a, const T* b, size_t n, OP op) {
+    switch (isa()) {
+        case ISA::AVX512:
+            return apply_array_avx512(a, b, n, op);
+        case ISA::AVX2:
+            return apply_array_avx2(a, b, n, op);
+        default:
+            return apply_array_sse2(a, b, n, op);
+    }
+}
+
+/** Compute op(a[i], v) for i in [0,n). */
+template <typename T, typename OP>
+void apply_value(T* a, T v, size_t n, OP op) {
+    switch (isa()) {
+        case ISA::AVX512:
+            return apply_value_avx512(a, v, n, op);
+        case ISA::AVX2:
+            return apply_value_avx2(a, v, n, op);
+        default:
+            return apply_value_sse2(a, v, n, op);
+    }
+}
+
+#else
+
+template <typename T, typename OP>
+void apply_array(T* a, const T* b, size_t n, OP op) {
+    apply_array_scalar(a, b, n, op);
+}
+
+template <typename T, typename OP>
+void apply_value(T* a, T v, size_t n, OP op) {
+    apply_value_scalar(a, v, n, op);
+}
+
+#endif
+
+}  // namespace simd_kernels
+
+#endif  // include protector
@@ -83,6 +83,30 @@ inline void serialize(Archive& ar, boost::multi_array<T, N>& a,
     split_free(ar, a, version);
 }
 
+template <class Archive, typename T, std::size_t N, typename Alloc>
+inline void save(Archive& ar, const NDArray<T, N, Alloc>& a,
+                 const unsigned int version) {
+    // an NDArray is always row-major with zero index bases, so only the shape
+    // and data are written
+    ar << make_array(a.shape(), N);
+    ar << make_array(a.data(), a.num_elements());
+}
+
+template <class Archive, typename T, std::size_t N, typename Alloc>
+inline void load(Archive& ar, NDArray<T, N, Alloc>& a,
+                 const unsigned int version) {
+    boost::array<multi_array_types::size_type, N> shape;
+    ar >> make_array(shape.data(), N);
+    a.resize(shape);
+    ar >> make_array(a.data(), a.num_elements());
+}
+
+template <typename Archive, typename T, std::size_t N, typename Alloc>
+inline void serialize(Archive& ar, NDArray<T, N, Alloc>& a,
+                      const unsigned int version) {
+    split_free(ar, a, version);
+}
+
 }  // namespace serialization
 }  // namespace boost
 
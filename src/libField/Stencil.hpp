@@ -0,0 +1,198 @@
+#ifndef Stencil_hpp
+#define Stencil_hpp
+
+/** @file Stencil.hpp
+ * @brief Neighborhood accessor for user defined stencil kernels (see
+ * Field::apply_stencil()).
+ * @author C.D. Clark III
+ * @date 10/16/26
+ */
+
+#include <algorithm>
+#include <array>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <cstdlib>
+
+#include "Utils.hpp"
+
+/**
+ * How Field::apply_stencil() treats the elements within the stencil radius of
+ * the boundary.
+ *
+ * Fixed: the elements are copied from the input, the kernel is not called for
+ * them (i.e. a Dirichlet boundary).
+ *
+ * Clamp: offsets past the boundary read the boundary element, and their
+ * coordinates are extrapolated from the spacing at the boundary.
+ *
+ * Periodic: offsets wrap around the axis. The spacing between the last and
+ * first elements is taken to be the average spacing of the axis (as for
+ * Boundary::Periodic).
+ */
+enum class StencilBoundary { Fixed, Clamp, Periodic };
+
+namespace detail {
+/**
+ * The layout of the elements and coordinates read by a stencil kernel.
+ * Elements and axes are addressed with strides, so views are supported.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+struct StencilGrid {
+    const QUANT* origin;
+    std::array<std::ptrdiff_t, NUMDIMS> stride;
+    std::array<std::ptrdiff_t, NUMDIMS> shape;
+    std::array<const COORD*, NUMDIMS> axis;
+    std::array<std::ptrdiff_t, NUMDIMS> axis_stride;
+    StencilBoundary bc;
+    std::ptrdiff_t radius;
+};
+}  // namespace detail
+
+/**
+ * The neighborhood of an element, passed to stencil kernels. Neighbors are
+ * addressed by their offsets from the element, and their coordinates can be
+ * read without going through the coordinate system.
+ *
+ * @code
+ * F.apply_stencil(G, 1, [](const auto& n) {
+ *   return n(-1, 0) + n(1, 0) + n(0, -1) + n(0, 1) - 4 * n(0, 0);
+ * });
+ * @endcode
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+class Neighborhood {
+   public:
+    explicit Neighborhood(
+        const detail::StencilGrid<QUANT, COORD, NUMDIMS>& grid)
+        : g(&grid) {}
+
+    /**
+     * @brief Return the element at offset (o0, o1, ...) from the center. The
+     * offsets must not be larger than the stencil radius.
+     */
+    template <typename... I>
+    const QUANT& operator()(I... o) const {
+        static_assert(sizeof...(I) == NUMDIMS,
+                      "one offset is needed for each dimension.");
+        const std::array<std::ptrdiff_t, NUMDIMS> off{
+            {static_cast<std::ptrdiff_t>(o)...}};
+        std::ptrdiff_t s = 0;
+        if (interior) {
+            for (size_t k = 0; k < NUMDIMS; ++k) s += off[k] * g->stride[k];
+            return p[s];
+        }
+        for (size_t k = 0; k < NUMDIMS; ++k) {
+            BOOST_ASSERT(std::abs(off[k]) <= g->radius);
+            const std::ptrdiff_t i = ind[k];
+            s += (_wrap(k, i + off[k]) - i) * g->stride[k];
+        }
+        return p[s];
+    }
+
+    /**
+     * @brief Return the index of the center element.
+     */
+    const std::array<size_t, NUMDIMS>& index() const { return ind; }
+
+    /**
+     * @brief Return the coordinate along axis k of the element at offset o
+     * (along axis k) from the center.
+     */
+    COORD coord(size_t k, std::ptrdiff_t o = 0) const {
+        const std::ptrdiff_t i = ind[k] + o, n = g->shape[k];
+        const COORD* a = g->axis[k];
+        const std::ptrdiff_t as = g->axis_stride[k];
+        if (0 <= i && i < n) return a[i * as];
+        if (g->bc == StencilBoundary::Periodic) {
+            const COORD period = (a[(n - 1) * as] - a[0]) * n / (n - 1);
+            const std::ptrdiff_t w = _wrap(k, i);
+            return a[w * as] + (i - w) / n * period;
+        }
+        if (n < 2) return a[0];
+        if (i < 0) return a[0] + i * (a[as] - a[0]);
+        const COORD b = a[(n - 1) * as];
+        return b + (i - n + 1) * (b - a[(n - 2) * as]);
+    }
+
+    /**
+     * @brief Return the coordinates of the center element.
+     */
+    std::array<COORD, NUMDIMS> coord() const {
+        std::array<COORD, NUMDIMS> x;
+        for (size_t k = 0; k < NUMDIMS; ++k) x[k] = coord(k);
+        return x;
+    }
+
+   protected:
+    // wrap or clamp index i along axis k, depending on the boundary.
+    std::ptrdiff_t _wrap(size_t k, std::ptrdiff_t i) const {
+        const std::ptrdiff_t n = g->shape[k];
+        if (g->bc == StencilBoundary::Periodic) return ((i % n) + n) % n;
+        return std::min(std::max(i, std::ptrdiff_t(0)), n - 1);
+    }
+
+    const detail::StencilGrid<QUANT, COORD, NUMDIMS>* g;
+    const QUANT* p = nullptr;
+    std::array<size_t, NUMDIMS> ind{};
+    // true if every neighbor within the radius is inside the array
+    bool interior = false;
+};
+
+namespace detail {
+/**
+ * The neighborhood that apply_stencil() moves along the rows of the grid.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS>
+class StencilCursor : public Neighborhood<QUANT, COORD, NUMDIMS> {
+    typedef Neighborhood<QUANT, COORD, NUMDIMS> base;
+
+   public:
+    using base::base;
+    using base::ind;
+    using base::interior;
+    using base::p;
+};
+
+/**
+ * Set each element of the output (addressed with out and out_stride) to
+ * kernel(neighborhood of the element in the input grid), in parallel.
+ */
+template <typename QUANT, typename COORD, size_t NUMDIMS, typename K>
+void apply_stencil(const StencilGrid<QUANT, COORD, NUMDIMS>& in, QUANT* out,
+                   const std::array<std::ptrdiff_t, NUMDIMS>& out_stride,
+                   K& kernel) {
+    const size_t N = NUMDIMS;
+    const std::ptrdiff_t r = in.radius;
+    std::array<size_t, N> shape;
+    for (size_t k = 0; k < N; ++k) shape[k] = in.shape[k];
+    const std::ptrdiff_t L = shape[N - 1];
+
+    auto row = [&](const std::array<size_t, N>& ind, size_t l0, size_t l1) {
+        StencilCursor<QUANT, COORD, N> c(in);
+        c.ind = ind;
+        std::ptrdiff_t bi = 0, bo = 0;
+        bool row_interior = true;
+        for (size_t k = 0; k + 1 < N; ++k) {
+            const std::ptrdiff_t i = ind[k];
+            bi += i * in.stride[k];
+            bo += i * out_stride[k];
+            row_interior = row_interior && i >= r && i + r < in.shape[k];
+        }
+        const Neighborhood<QUANT, COORD, N>& n = c;
+        for (std::ptrdiff_t l = l0; l < std::ptrdiff_t(l1); ++l) {
+            c.ind[N - 1] = l;
+            c.p = in.origin + bi + l * in.stride[N - 1];
+            c.interior = row_interior && l >= r && l + r < L;
+            QUANT& y = out[bo + l * out_stride[N - 1]];
+            if (!c.interior && in.bc == StencilBoundary::Fixed)
+                y = *c.p;
+            else
+                y = kernel(n);
+        }
+    };
+    for_each_row(shape, r, L * sizeof(QUANT), row);
+}
+}  // namespace detail
+
+#endif
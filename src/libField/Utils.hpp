@@ -2,9 +2,14 @@
 #ifndef Utils_hpp
 #define Utils_hpp
 
+#include <algorithm>
+#include <array>
 #include <boost/array.hpp>
 #include <boost/assert.hpp>
 #include <boost/multi_array.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /** @file Utils.hpp
  * @brief
@@ -37,6 +42,44 @@ struct IsIndexCont<std::array<int, N>> : std::true_type {};
 template <size_t N>
 struct IsIndexCont<std::array<size_t, N>> : std::true_type {};
 
+/** True if the array type owns a single block of elements that can be
+ * accessed through data() (i.e. it is a boost::multi_array or
+ * boost::multi_array_ref, not a view).*/
+template <typename A>
+struct IsContiguousArray
+    : std::is_base_of<boost::multi_array_ref<typename A::element,
+                                             A::dimensionality>,
+                      typename std::remove_const<A>::type> {};
+
+/** True for Field types. Specialized in Field.hpp. */
+template <typename T>
+struct IsField : std::false_type {};
+
+/** True for lazily evaluated field expressions. Specialized in
+ * Expressions.hpp. */
+template <typename T>
+struct IsFieldExpression : std::false_type {};
+
+/** True if ARRAY<T,N> is an array type that owns its elements, i.e. it can
+ * be allocated from its sizes. Views and refs do not, and arrays with fixed
+ * extents only exist for their own number of dimensions. */
+template <template <typename, size_t> class ARRAY, typename T, size_t N>
+struct IsOwningArray {
+    template <template <typename, size_t> class A>
+    static auto test(int)
+        -> std::is_constructible<A<T, N>, std::vector<size_t>>;
+    template <template <typename, size_t> class A>
+    static auto test(...) -> std::false_type;
+
+    static constexpr bool value = decltype(test<ARRAY>(0))::value;
+};
+
+/** True if ARRAY<T> is a 1D array type that owns its elements (see
+ * IsOwningArray). */
+template <template <typename> class ARRAY, typename T>
+struct IsOwningArray1D
+    : std::is_constructible<ARRAY<T>, decltype(boost::extents[0])> {};
+
 // trait queries
 
 template <template <typename, size_t> class ARRAY, typename T, size_t N>
@@ -57,4 +100,215 @@ struct IsCallable {
 
 // type generators
 
+/**
+ * A non-owning view of a contiguous sequence of elements (i.e. a pointer and
+ * a size).
+ */
+template <typename T>
+class Span {
+   public:
+    Span() = default;
+    Span(T* data, size_t size) : ptr(data), n(size) {}
+    /** View the elements of a contiguous container (std::vector, std::array,
+     * or another Span). */
+    template <typename C,
+              typename = std::enable_if_t<std::is_convertible<
+                  decltype(std::declval<C&>().data()), T*>::value>>
+    Span(C& c) : ptr(c.data()), n(c.size()) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    T& operator[](size_t i) const { return ptr[i]; }
+
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + n; }
+
+   protected:
+    T* ptr = nullptr;
+    size_t n = 0;
+};
+
+/**
+ * How the partial results of a parallel reduction are combined (see
+ * detail::reduce_blocks()).
+ *
+ * Fast: combine per-thread results as threads finish. The round off in sums
+ * may change with the number of threads.
+ *
+ * Reproducible: combine fixed-size blocks pairwise in a fixed order. Sums are
+ * bitwise identical for any number of threads.
+ */
+enum class ReductionMode { Fast, Reproducible };
+
+namespace detail {
+/**
+ * Number of elements processed as a single unit by the parallel loops over
+ * field elements. Every bulk operation partitions the elements the same way, so
+ * a given element is always handled by the same thread.
+ */
+constexpr size_t block_size = 4096;
+
+/**
+ * Call op(begin,end) for each block of [0,N) in parallel using OpenMP. Blocks
+ * are handed out statically, in order.
+ */
+template <typename OP>
+void for_each_block(size_t N, OP op) {
+    const size_t NB = (N + block_size - 1) / block_size;
+#pragma omp parallel for schedule(static)
+    for (size_t ib = 0; ib < NB; ++ib) {
+        size_t b = ib * block_size;
+        op(b, std::min(N, b + block_size));
+    }
+}
+
+/**
+ * Like for_each_block(N, op), but each thread creates a scratch object with
+ * init() before its first block, and calls op(scratch, begin, end) for each of
+ * its blocks with it (i.e. to allocate buffers once per thread instead of once
+ * per block). Blocks are handed out to the threads in the same way.
+ */
+template <typename INIT, typename OP>
+void for_each_block(size_t N, INIT init, OP op) {
+    const size_t NB = (N + block_size - 1) / block_size;
+#pragma omp parallel
+    {
+        auto scratch = init();
+#pragma omp for schedule(static)
+        for (size_t ib = 0; ib < NB; ++ib) {
+            size_t b = ib * block_size;
+            op(scratch, b, std::min(N, b + block_size));
+        }
+    }
+}
+
+/**
+ * Call op(ind, l0, l1) for the rows (runs of elements along the last axis) of a
+ * row-major array with the given shape, in parallel using OpenMP. ind is the
+ * index of the first element of the row (with ind[N-1] == 0), and [l0,l1) is
+ * the range of the row to process.
+ *
+ * Stencil operations read the rows within halo of a row along each of the
+ * other axes, so rows are handed out in tiles that cover a range of the second
+ * to last axis for 16 consecutive indices of the slower axes. The range is
+ * chosen so that the rows read by a tile (row_bytes each) fit in the L2 cache.
+ * One dimensional arrays are split into segments of block_size elements.
+ */
+template <size_t N, typename OP>
+void for_each_row(const std::array<size_t, N>& shape, size_t halo,
+                  size_t row_bytes, OP op) {
+    const size_t L = shape[N - 1];
+    size_t total = 1;
+    for (size_t k = 0; k < N; ++k) total *= shape[k];
+    if (total == 0) return;
+
+    // rows are indexed by (o, j), where j is the index along axis N-2, and o
+    // is the (flattened) index along the axes before it.
+    const size_t J = N > 1 ? shape[N - 2] : 1;
+    const size_t O = total / (J * L);
+    const size_t l2 = 256 * 1024, w = 2 * halo + 1;
+    const size_t TJ =
+        std::max<size_t>(w, l2 / (w * row_bytes + 1)) - (w - 1);
+    const size_t TO = 16;
+    const size_t TL = N > 1 ? L : block_size;
+
+    const size_t nJ = (J + TJ - 1) / TJ, nO = (O + TO - 1) / TO,
+                 nL = (L + TL - 1) / TL;
+    const std::ptrdiff_t ntiles = nJ * nO * nL;
+#pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t tile = 0; tile < ntiles; ++tile) {
+        const size_t tl = tile % nL, tj = (tile / nL) % nJ,
+                     to = tile / (nL * nJ);
+        const size_t l0 = tl * TL, l1 = std::min(L, l0 + TL);
+        for (size_t o = to * TO; o < std::min(O, (to + 1) * TO); ++o) {
+            for (size_t j = tj * TJ; j < std::min(J, (tj + 1) * TJ); ++j) {
+                std::array<size_t, N> ind;
+                ind[N - 1] = 0;
+                size_t r = o * J + j;
+                for (size_t k = N - 1; k-- > 0;) {
+                    ind[k] = r % shape[k];
+                    r /= shape[k];
+                }
+                op(ind, l0, l1);
+            }
+        }
+    }
+}
+
+/**
+ * Sum get(i) for i in [b,e) by pairwise (cascade) summation: the range is split
+ * in half recursively, and short ranges are summed in a loop. The round off
+ * error grows with log(e - b) instead of e - b, and the order of the additions
+ * only depends on b and e.
+ */
+template <typename T, typename GET>
+T pairwise_sum(size_t b, size_t e, GET get) {
+    if (e - b <= 32) {
+        T s = T();
+        for (size_t i = b; i < e; ++i) s += get(i);
+        return s;
+    }
+    const size_t m = b + (e - b) / 2;
+    return pairwise_sum<T>(b, m, get) + pairwise_sum<T>(m, e, get);
+}
+
+/**
+ * Reduce [0,N) in parallel using OpenMP. block(begin,end) returns the result
+ * for one block of the range (the same blocks as for_each_block), and
+ * combine(x,y) combines two results. init must be the identity of combine.
+ *
+ * In Reproducible mode, the block results are stored and combined pairwise
+ * in a fixed order, so the result does not depend on the number of threads.
+ * In Fast mode, each thread combines the results for the blocks it was given,
+ * and the per-thread results are combined in the order the threads finish.
+ */
+template <typename T, typename BLOCK, typename COMBINE>
+T reduce_blocks(size_t N, T init, BLOCK block, COMBINE combine,
+                ReductionMode mode) {
+    const size_t NB = (N + block_size - 1) / block_size;
+    if (mode == ReductionMode::Reproducible) {
+        std::vector<T> r(NB, init);
+        for_each_block(N, [&](size_t b, size_t e) {
+            r[b / block_size] = block(b, e);
+        });
+        // combine neighbors until one is left
+        for (size_t w = 1; w < NB; w *= 2)
+            for (size_t i = 0; i + w < NB; i += 2 * w)
+                r[i] = combine(r[i], r[i + w]);
+        return NB > 0 ? r[0] : init;
+    }
+    T result = init;
+#pragma omp parallel
+    {
+        T r = init;
+#pragma omp for schedule(static) nowait
+        for (size_t ib = 0; ib < NB; ++ib) {
+            size_t b = ib * block_size;
+            r = combine(r, block(b, std::min(N, b + block_size)));
+        }
+#pragma omp critical(libfield_reduce_blocks)
+        result = combine(result, r);
+    }
+    return result;
+}
+
+/**
+ * Return a pointer to the first element of an array if its elements are stored
+ * contiguously in row-major (C) order, and a null pointer otherwise.
+ */
+template <typename A,
+          typename std::enable_if<IsContiguousArray<A>::value, int>::type = 0>
+auto contiguous_data(A& a) -> decltype(a.data()) {
+    return a.storage_order() == boost::c_storage_order() ? a.data() : nullptr;
+}
+
+template <typename A,
+          typename std::enable_if<!IsContiguousArray<A>::value, int>::type = 0>
+auto contiguous_data(A& a) -> decltype(a.origin()) {
+    return nullptr;
+}
+}  // namespace detail
+
 #endif  // include protector
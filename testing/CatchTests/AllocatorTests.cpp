@@ -0,0 +1,271 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <libField/Field.hpp>
+#include <vector>
+
+#include "Utils.h"
+
+template<typename T>
+bool is_aligned(const T* p, size_t align)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+TEST_CASE("Aligned Allocator")
+{
+  SECTION("Allocations are aligned")
+  {
+    allocators::AlignedAllocator<double>       a64;
+    allocators::AlignedAllocator<float, 256>   a256;
+    allocators::AlignedAllocator<char, 64, true> ahuge;
+
+    for(size_t n : {0, 1, 3, 100, 1000}) {
+      double* p = a64.allocate(n);
+      CHECK(is_aligned(p, 64));
+      a64.deallocate(p, n);
+
+      float* q = a256.allocate(n);
+      CHECK(is_aligned(q, 256));
+      a256.deallocate(q, n);
+    }
+
+    // large allocations are aligned to huge pages
+    size_t n = 3 * allocators::huge_page_size + 1;
+    char*  p = ahuge.allocate(n);
+    CHECK(is_aligned(p, allocators::huge_page_size));
+    p[0] = p[n - 1] = 1;
+    ahuge.deallocate(p, n);
+
+    // small ones are not
+    p = ahuge.allocate(10);
+    CHECK(is_aligned(p, 64));
+    ahuge.deallocate(p, 10);
+  }
+
+  SECTION("Can be used with standard containers")
+  {
+    std::vector<int, allocators::AlignedAllocator<int, 128>> v(1000, 1);
+    CHECK(is_aligned(v.data(), 128));
+    v.resize(3000, 2);
+    CHECK(is_aligned(v.data(), 128));
+    CHECK(v[999] == 1);
+    CHECK(v[1000] == 2);
+  }
+
+  SECTION("Fields with aligned storage")
+  {
+    Field<double, 2, double, alignedArrayND> F(10, 21), G(10, 21);
+    CHECK(is_aligned(F.data(), 64));
+    F.setCoordinateSystem(Uniform(0, 9), Uniform(0, 20));
+    G.setCoordinateSystem(Uniform(0, 9), Uniform(0, 20));
+    F.set_f([](auto x) { return x[0] + 100 * x[1]; });
+    G = 1.0;
+    F += G;
+    F = 2 * F - G;
+
+    auto H = F;
+    CHECK(is_aligned(H.data(), 64));
+    for(int i = 0; i < 10; ++i)
+      for(int j = 0; j < 21; ++j)
+        CHECK(H(i, j) == Catch::Approx(2 * (i + 100. * j + 1) - 1));
+
+    auto S = F.slice(indices[IRange()][5]);
+    S      = 0.0;
+    for(int i = 0; i < 10; ++i) CHECK(F(i, 5) == 0.0);
+
+    F.reset(1000, 1000);
+    CHECK(is_aligned(F.data(), 64));
+  }
+
+  SECTION("Fields with huge page storage")
+  {
+    Field<double, 3, double, hugePageArrayND> F(100, 100, 100);
+    CHECK(is_aligned(F.data(), allocators::huge_page_size));
+    F = 1.0;
+    F *= 2.0;
+    CHECK(F(99, 99, 99) == 2.0);
+  }
+}
+
+TEST_CASE("First Touch Allocator")
+{
+  SECTION("Memory is zeroed")
+  {
+    allocators::FirstTouchAllocator<double> alloc;
+    // small allocations are zeroed serially, large ones in parallel
+    for(size_t n : {size_t(1), size_t(17), 3 * detail::block_size + 17}) {
+      double* p = alloc.allocate(n);
+      CHECK(is_aligned(p, 64));
+      CHECK(std::count(p, p + n, 0.0) == static_cast<long>(n));
+      alloc.deallocate(p, n);
+    }
+  }
+
+  SECTION("Non-trivial types are constructed")
+  {
+    std::vector<std::vector<int>,
+                allocators::FirstTouchAllocator<std::vector<int>>>
+        v(10, std::vector<int>(3, 7));
+    v.emplace_back(2, 5);
+    CHECK(v[9].size() == 3);
+    CHECK(v[9][2] == 7);
+    CHECK(v[10][1] == 5);
+  }
+
+  SECTION("Fields with first touch storage")
+  {
+    Field<double, 3, double, firstTouchArrayND> F(30, 40, 50), G(F);
+    CHECK(std::count(F.data(), F.data() + F.size(), 0.0) ==
+          static_cast<long>(F.size()));
+    F.setCoordinateSystem(Uniform(0, 1), Uniform(0, 1), Uniform(0, 1));
+    F.set_f([](auto x) { return x[0] + x[1] + x[2]; });
+    G = 1.0;
+    F += G;
+    CHECK(F(29, 39, 49) == Catch::Approx(4));
+    CHECK(F(0, 0, 0) == Catch::Approx(1));
+  }
+}
+
+TEST_CASE("First Touch vs. Serial Initialization", "[.][benchmarks]")
+{
+  // on a multi-socket machine, the bandwidth of the field operators depends
+  // on which NUMA node the pages of the fields were placed on.
+  Field<double, 3>                            F(256, 256, 256), G(F);
+  Field<double, 3, double, firstTouchArrayND> A(256, 256, 256), B(A);
+  F = G = 1.0;
+  A = B = 1.0;
+
+  BENCHMARK("Construct Serial")
+  {
+    Field<double, 3> T(256, 256, 256);
+    return T.size();
+  };
+  BENCHMARK("Construct First Touch")
+  {
+    Field<double, 3, double, firstTouchArrayND> T(256, 256, 256);
+    return T.size();
+  };
+  BENCHMARK("Field += Field Serial") { return (F += G).size(); };
+  BENCHMARK("Field += Field First Touch") { return (A += B).size(); };
+}
+
+TEST_CASE("Aligned vs. Default Field Storage", "[.][benchmarks]")
+{
+  Field<double, 3>                          F(200, 200, 200), G(F);
+  Field<double, 3, double, alignedArrayND>  A(200, 200, 200), B(A);
+  Field<double, 3, double, hugePageArrayND> H(200, 200, 200), K(H);
+  F = G = 1.0;
+  A = B = 1.0;
+  H = K = 1.0;
+
+  BENCHMARK("Default") { return (F += G).size(); };
+  BENCHMARK("Aligned") { return (A += B).size(); };
+  BENCHMARK("Huge Pages") { return (H += K).size(); };
+}
+
+TEST_CASE("Arena Allocator")
+{
+  typedef Field<double, 1, double, arenaArrayND, arenaArray1D> ArenaField;
+
+  SECTION("Arena")
+  {
+    allocators::Arena arena(1024);
+    void*             p = arena.allocate(10, 1);
+    void*             q = arena.allocate(8, 8);
+    CHECK(is_aligned(q, 8));
+    CHECK(static_cast<char*>(q) - static_cast<char*>(p) == 16);
+    CHECK(arena.bytes_used() == 18);
+    CHECK(arena.bytes_reserved() == 1024);
+
+    // large requests get their own chunk
+    arena.allocate(4000, 64);
+    CHECK(arena.bytes_reserved() > 5000);
+
+    arena.release();
+    CHECK(arena.bytes_used() == 0);
+    CHECK(arena.bytes_reserved() == 0);
+  }
+
+  SECTION("Scopes")
+  {
+    allocators::Arena a, b;
+    CHECK(allocators::Arena::current() == nullptr);
+    {
+      allocators::ArenaScope sa(a);
+      CHECK(allocators::Arena::current() == &a);
+      {
+        allocators::ArenaScope sb(b);
+        CHECK(allocators::Arena::current() == &b);
+        CHECK(allocators::ArenaAllocator<int>().getArena() == &b);
+      }
+      CHECK(allocators::Arena::current() == &a);
+    }
+    CHECK(allocators::Arena::current() == nullptr);
+
+    // without an arena, memory comes from the heap
+    allocators::ArenaAllocator<int> alloc;
+    CHECK(alloc.getArena() == nullptr);
+    int* p = alloc.allocate(10);
+    alloc.deallocate(p, 10);
+  }
+
+  SECTION("Fields are allocated from the arena")
+  {
+    allocators::Arena       arena;
+    std::vector<ArenaField> fields;
+    fields.reserve(100);
+    {
+      allocators::ArenaScope scope(arena);
+      for(int i = 0; i < 100; ++i) {
+        fields.emplace_back(10);
+        fields.back().setCoordinateSystem(Uniform(0, 1));
+        fields.back() = i;
+      }
+    }
+    // elements, element array, coordinate system, axis, and control blocks
+    CHECK(arena.bytes_used() > 100 * (10 + 10) * sizeof(double));
+    CHECK(arena.bytes_reserved() == 1024 * 1024);
+
+    const size_t used = arena.bytes_used();
+    for(int i = 0; i < 100; ++i) {
+      auto& F = fields[i];
+      F *= 2;
+      F += F;
+      CHECK(F(3) == 4. * i);
+      CHECK(F.getCoord(9) == Catch::Approx(1));
+    }
+    CHECK(arena.bytes_used() == used);
+
+    // copies of arena arrays allocate from the same arena
+    ArenaField G(fields[10]);
+    CHECK(G(3) == 40.);
+    CHECK(arena.bytes_used() > used);
+  }
+}
+
+TEST_CASE("Arena vs. Heap Allocated Fields", "[.][benchmarks]")
+{
+  typedef Field<double, 1, double, arenaArrayND, arenaArray1D> ArenaField;
+
+  BENCHMARK("Heap")
+  {
+    std::vector<Field<double, 1>> fields;
+    fields.reserve(10000);
+    for(int i = 0; i < 10000; ++i) fields.emplace_back(64);
+    return fields.size();
+  };
+
+  BENCHMARK("Arena")
+  {
+    allocators::Arena       arena;
+    std::vector<ArenaField> fields;
+    fields.reserve(10000);
+    allocators::ArenaScope scope(arena);
+    for(int i = 0; i < 10000; ++i) fields.emplace_back(64);
+    return fields.size();
+  };
+}
@@ -63,6 +63,14 @@ TEST_CASE("Array of Objects vs. Object of Arrays", "[.][benchmarks]")
         }
       }
     };
+
+    BENCHMARK("Pointwise")
+    {
+      for(int n = 0; n < Nt; ++n) {
+        for(int i = 0; i < Nx; ++i)
+          Nodes(i).T += dt * Nodes(i).kappa / (Nodes(i).rho * Nodes(i).c);
+      }
+    };
   }
 
   SECTION("Object of Arrays")
@@ -95,5 +103,49 @@ TEST_CASE("Array of Objects vs. Object of Arrays", "[.][benchmarks]")
         }
       }
     };
+
+    BENCHMARK("Pointwise")
+    {
+      for(int n = 0; n < Nt; ++n) {
+        for(int i = 0; i < Nx; ++i)
+          Fields.T(i) += dt * Fields.kappa(i) / (Fields.rho(i) * Fields.c(i));
+      }
+    };
+  }
+
+  SECTION("MultiField")
+  {
+    MultiField<double, 1, 4> Fields(Nx);
+    Fields.setNames({"T", "rho", "c", "kappa"});
+    Fields.setCoordinateSystem(Uniform(0., 10.));
+    auto& T     = Fields["T"];
+    auto& rho   = Fields["rho"];
+    auto& c     = Fields["c"];
+    auto& kappa = Fields["kappa"];
+
+    rho   = 2.;
+    c     = 3.;
+    kappa = 4.;
+    T.set_f([&](auto i, auto cs) { return i[0] * (Nx - 1 - i[0]); });
+
+    BENCHMARK("Conduction")
+    {
+      for(int n = 0; n < Nt; ++n) {
+        for(int i = 1; i < Nx - 1; ++i) {
+          T(i) = kappa(i) / (rho(i) * c(i)) * (dt / dx) *
+                     (T(i - 1) - 2 * T(i) + T(i + 1)) +
+                 T(i);
+        }
+      }
+    };
+
+    BENCHMARK("Pointwise")
+    {
+      for(int n = 0; n < Nt; ++n) {
+        Fields.for_each([&](double& T, double rho, double c, double kappa) {
+          T += dt * kappa / (rho * c);
+        });
+      }
+    };
   }
 }
@@ -36,3 +36,12 @@ TEST_CASE("Using Boost.Units")
 
 }
 
+TEST_CASE("Scaling a Field by a Dimensionless Quantity")
+{
+  Field<double,1> f(3);
+  f = 1.5;
+  f *= q<boost::units::si::dimensionless>(2.0);
+  CHECK(f(0) == Catch::Approx(3));
+  CHECK(f(2) == Catch::Approx(3));
+}
+
@@ -1,6 +1,13 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 #include <libField/CoordinateSystem.hpp>
+#include <libField/Field.hpp>
+#include <random>
+#include <vector>
 
 #include "Utils.h"
 
@@ -332,6 +339,399 @@ TEST_CASE("CoordinateSystem Index Searching")
   CHECK_THAT(ind, IsEqualToArray<A>({10, 5, 20}));
 }
 
+template<typename CS, typename C>
+void check_lookups(const CS& cs, const std::vector<C>& coords)
+{
+  const auto& a = cs.getAxis(0);
+  for(auto c : coords) {
+    int ub = std::upper_bound(a.begin(), a.end(), c) - a.begin();
+    CHECK(cs.upper_bound(c)[0] == ub);
+    CHECK(cs.lower_bound(c)[0] == ub - 1);
+  }
+}
+
+TEST_CASE("CoordinateSystem Analytic Lookups")
+{
+  typedef CoordinateSystem<double, 1> CS;
+  typedef CS::AxisLookup::Kind        Kind;
+
+  std::mt19937                           gen(7);
+  std::uniform_real_distribution<double> dist(-3, 13);
+  std::vector<double>                    coords(2000);
+  for(auto& c : coords) c = dist(gen);
+
+  SECTION("Uniform")
+  {
+    CS cs(1001);
+    cs.set(Uniform(-1., 9.));
+    CHECK(cs.getAxisLookup(0).kind == Kind::Uniform);
+    // include the axis values themselves
+    for(size_t i = 0; i < 1001; ++i) coords.push_back(cs[0][i]);
+    check_lookups(cs, coords);
+    CHECK(cs.nearest(2.004)[0] == 300);
+    CHECK(cs.nearest(2.006)[0] == 301);
+  }
+
+  SECTION("Geometric")
+  {
+    CS cs(50);
+    cs.set(Geometric(0., 0.01, 1.1));
+    CHECK(cs.getAxisLookup(0).kind == Kind::Geometric);
+    for(size_t i = 0; i < 50; ++i) coords.push_back(cs[0][i]);
+    check_lookups(cs, coords);
+  }
+
+  SECTION("Float coordinates")
+  {
+    CoordinateSystem<float, 1> cs(777);
+    cs.set(Uniform(0.1f, 10.3f));
+    std::vector<float> fcoords(coords.begin(), coords.end());
+    for(size_t i = 0; i < 777; ++i) fcoords.push_back(cs[0][i]);
+    check_lookups(cs, fcoords);
+  }
+
+  SECTION("Other ranges are searched")
+  {
+    CS cs(100);
+    cs.set([](size_t i, size_t N) { return 0.1 * i * i; });
+    CHECK(cs.getAxisLookup(0).kind == Kind::None);
+    check_lookups(cs, coords);
+  }
+
+  SECTION("Modified axes")
+  {
+    CS cs(100);
+    cs.set(Uniform(0., 10.));
+    for(size_t i = 0; i < 100; ++i) cs[0][i] = 0.001 * i * i;
+    check_lookups(cs, coords);
+  }
+
+  SECTION("Deep copies keep the lookup")
+  {
+    CS cs(100);
+    cs.set(Uniform(0., 10.));
+    CS copy(cs, CS::DeepCopy());
+    CHECK(copy.getAxisLookup(0).kind == Kind::Uniform);
+    CHECK(&copy.getAxis(0) != &cs.getAxis(0));
+    check_lookups(copy, coords);
+  }
+}
+
+TEST_CASE("CoordinateSystem Lookup Performance", "[.][benchmarks]")
+{
+  std::mt19937                           gen(7);
+  std::uniform_real_distribution<double> dist(0, 1);
+  std::vector<double>                    coords(100000);
+  for(auto& c : coords) c = dist(gen);
+
+  for(size_t n : {10000, 1000000}) {
+    CoordinateSystem<double, 1> analytic(n), searched(n);
+    analytic.set(Uniform(0., 1.));
+    searched.set([](size_t i, size_t N) { return 1. * i / (N - 1); });
+
+    BENCHMARK("Uniform lookup, n = " + std::to_string(n))
+    {
+      long sum = 0;
+      for(auto c : coords) sum += analytic.lower_bound(c)[0];
+      return sum;
+    };
+    BENCHMARK("Binary search, n = " + std::to_string(n))
+    {
+      long sum = 0;
+      for(auto c : coords) sum += searched.lower_bound(c)[0];
+      return sum;
+    };
+  }
+}
+
+TEST_CASE("CoordinateSystem Search Index")
+{
+  typedef CoordinateSystem<double, 1> CS;
+  typedef CS::SearchIndex             Index;
+
+  std::mt19937                           gen(3);
+  std::uniform_real_distribution<double> dist(-1, 11);
+  std::vector<double>                    coords(2000);
+  for(auto& c : coords) c = dist(gen);
+
+  SECTION("Buckets")
+  {
+    // including empty buckets, and buckets with many values
+    for(size_t n = 0; n < 70; ++n) {
+      std::vector<double> a(n);
+      for(size_t i = 0; i < n; ++i) a[i] = 0.001 * i * i * i;
+      Index index(a);
+      CHECK(index.size() == n);
+      for(double c = -1; c < 0.001 * n * n * n + 1; c += 0.25) {
+        size_t ub = std::upper_bound(a.begin(), a.end(), c) - a.begin();
+        auto   r  = index.range(c);
+        CHECK(r.first <= ub);
+        CHECK(ub <= r.second);
+      }
+    }
+  }
+
+  SECTION("Lookups")
+  {
+    CS cs(1000);
+    cs.set([](size_t i, size_t N) { return 1e-5 * i * i; });
+    CHECK(!cs.getSearchIndex());
+    cs.setSearchIndex();
+    CHECK(cs.getSearchIndex());
+    for(size_t i = 0; i < 1000; ++i) coords.push_back(cs[0][i]);
+    check_lookups(cs, coords);
+    CHECK(cs.nearest(0.0026)[0] == 16);
+  }
+
+  SECTION("Modified axes")
+  {
+    CS cs(100);
+    cs.set([](size_t i, size_t N) { return 0.1 * i; });
+    cs.setSearchIndex();
+    check_lookups(cs, coords);
+    // the index is rebuilt by the next lookup
+    for(size_t i = 0; i < 100; ++i) cs[0][i] = 0.001 * i * i;
+    check_lookups(cs, coords);
+    // through a reference kept from before, the index is stale, so the axis
+    // is searched until it is rebuilt
+    auto& a = cs.getAxis(0);
+    check_lookups(cs, coords);
+    for(size_t i = 0; i < 100; ++i) a[i] = 0.002 * i * i;
+    check_lookups(cs, coords);
+    cs.setSearchIndex();
+    check_lookups(cs, coords);
+    // and after set()
+    cs.set([](size_t i, size_t N) { return std::sqrt(1. * i); });
+    check_lookups(cs, coords);
+    CS copy(cs, CS::DeepCopy());
+    CHECK(copy.getSearchIndex());
+    check_lookups(copy, coords);
+  }
+
+  SECTION("Fields")
+  {
+    Field<double, 2> F(50, 60);
+    F.setCoordinateSystem([](size_t i, size_t N) { return 0.01 * i * i; },
+                          [](size_t i, size_t N) { return std::sqrt(i); });
+    F.getCoordinateSystem().setSearchIndex();
+    F.set_f([](auto x) { return x[0] + 2 * x[1]; });
+    CHECK(F.interp(4.5, 3.5) == Catch::Approx(11.5));
+  }
+}
+
+TEST_CASE("CoordinateSystem Search Index Performance", "[.][benchmarks]")
+{
+  std::mt19937                           gen(7);
+  std::uniform_real_distribution<double> dist(0, 1);
+  std::vector<double>                    coords(100000);
+  for(auto& c : coords) c = dist(gen);
+
+  for(size_t n : {100, 10000, 1000000, 10000000}) {
+    CoordinateSystem<double, 1> searched(n), indexed(n);
+    auto f = [](size_t i, size_t N) { return std::sqrt(1. * i / (N - 1)); };
+    searched.set(f);
+    indexed.set(f);
+    indexed.setSearchIndex();
+    indexed.lower_bound(0.5);
+
+    BENCHMARK("Binary search, n = " + std::to_string(n))
+    {
+      long sum = 0;
+      for(auto c : coords) sum += searched.lower_bound(c)[0];
+      return sum;
+    };
+    BENCHMARK("Search index, n = " + std::to_string(n))
+    {
+      long sum = 0;
+      for(auto c : coords) sum += indexed.lower_bound(c)[0];
+      return sum;
+    };
+  }
+}
+
+template<typename CS>
+void check_batched(const CS& cs, const std::vector<double>& coords)
+{
+  auto lb = cs.lower_bound_batched(0, coords);
+  auto ub = cs.upper_bound_batched(0, coords);
+  auto nr = cs.nearest_batched(0, coords);
+  REQUIRE(lb.size() == coords.size());
+  for(size_t i = 0; i < coords.size(); ++i) {
+    CHECK(lb[i] == cs.lower_bound(coords[i])[0]);
+    CHECK(ub[i] == cs.upper_bound(coords[i])[0]);
+    CHECK(nr[i] == cs.nearest(coords[i])[0]);
+  }
+}
+
+TEST_CASE("CoordinateSystem Batched Lookups")
+{
+  typedef CoordinateSystem<double, 1> CS;
+
+  std::mt19937                           gen(5);
+  std::uniform_real_distribution<double> dist(-1, 11);
+  // more than one parallel block
+  std::vector<double> coords(3 * ::detail::block_size + 100);
+  for(auto& c : coords) c = dist(gen);
+
+  CS nonuniform(500), uniform(500);
+  nonuniform.set([](size_t i, size_t N) { return 4e-5 * i * i; });
+  uniform.set(Uniform(0., 10.));
+
+  SECTION("Sorted")
+  {
+    std::sort(coords.begin(), coords.end());
+    check_batched(nonuniform, coords);
+    check_batched(uniform, coords);
+    std::reverse(coords.begin(), coords.end());
+    check_batched(nonuniform, coords);
+  }
+
+  SECTION("Unsorted")
+  {
+    check_batched(nonuniform, coords);
+    check_batched(uniform, coords);
+  }
+
+  SECTION("Axis values")
+  {
+    coords.clear();
+    for(size_t i = 0; i < 500; ++i) coords.push_back(nonuniform[0][i]);
+    check_batched(nonuniform, coords);
+    CHECK(nonuniform.nearest(nonuniform[0][499])[0] == 499);
+  }
+
+  SECTION("Spans")
+  {
+    std::vector<int> ind(coords.size() - 10);
+    nonuniform.lower_bound_batched(
+        0, Span<const double>(coords.data() + 10, ind.size()), ind);
+    for(size_t i = 0; i < ind.size(); ++i)
+      CHECK(ind[i] == nonuniform.lower_bound(coords[i + 10])[0]);
+
+    std::vector<double> none;
+    CHECK(nonuniform.lower_bound_batched(0, none).empty());
+  }
+
+  SECTION("Fields")
+  {
+    Field<double, 2> F(500, 10);
+    F.setCoordinateSystem([](size_t i, size_t N) { return 4e-5 * i * i; },
+                          Uniform(0., 1.));
+    std::vector<int> ind(coords.size());
+    F.lower_bound_batched(0, coords, ind);
+    CHECK(ind == nonuniform.lower_bound_batched(0, coords));
+    F.nearest_batched(0, coords, ind);
+    CHECK(ind == nonuniform.nearest_batched(0, coords));
+    CHECK(F.upper_bound_batched(1, coords).size() == coords.size());
+  }
+}
+
+TEST_CASE("CoordinateSystem Batched Lookup Performance", "[.][benchmarks]")
+{
+  std::mt19937                           gen(7);
+  std::uniform_real_distribution<double> dist(0, 1);
+  std::vector<double>                    coords(1000000);
+  for(auto& c : coords) c = dist(gen);
+  std::sort(coords.begin(), coords.end());
+  std::vector<int> ind(coords.size());
+
+  for(size_t n : {1000, 1000000}) {
+    CoordinateSystem<double, 1> cs(n);
+    cs.set([](size_t i, size_t N) { return std::sqrt(1. * i / (N - 1)); });
+
+    BENCHMARK("Single lookups, n = " + std::to_string(n))
+    {
+      for(size_t i = 0; i < coords.size(); ++i)
+        ind[i] = cs.lower_bound(coords[i])[0];
+      return ind[10];
+    };
+    BENCHMARK("Batched lookups, n = " + std::to_string(n))
+    {
+      cs.lower_bound_batched(0, coords, ind);
+      return ind[10];
+    };
+  }
+}
+
+TEST_CASE("CoordinateSystem Lookup Cursor")
+{
+  typedef CoordinateSystem<double, 2> CS;
+  typedef std::array<int, 2>          A;
+
+  CS cs(300, 40);
+  cs.set([](size_t i, size_t N) { return 1e-4 * i * i; }, Uniform(-1., 1.));
+
+  std::mt19937                           gen(11);
+  std::uniform_real_distribution<double> step(-0.02, 0.02);
+
+  SECTION("Random walks")
+  {
+    auto   cur = cs.cursor();
+    double x = 4.5, y = 0;
+    for(int i = 0; i < 5000; ++i) {
+      // occasionally jump, and leave the axes
+      x += i % 500 == 0 ? 20 * step(gen) : step(gen);
+      y += step(gen);
+      CHECK_THAT(cur.lower_bound(x, y), IsEqualToArray<A>(cs.lower_bound(x, y)));
+      CHECK_THAT(cur.upper_bound(x, y), IsEqualToArray<A>(cs.upper_bound(x, y)));
+      CHECK_THAT(cur.nearest(x, y), IsEqualToArray<A>(cs.nearest(x, y)));
+      CHECK(cur.bracket(0, x) == cs.bracket(0, x));
+    }
+  }
+
+  SECTION("Reset")
+  {
+    auto cur = cs.cursor();
+    CHECK_THAT(cur.lower_bound(1, 0), IsEqualToArray<A>({100, 19}));
+    CHECK_THAT(cur.lower_bound(8, 0.99), IsEqualToArray<A>({282, 38}));
+    cur.reset();
+    CHECK_THAT(cur.lower_bound(1, 0), IsEqualToArray<A>({100, 19}));
+    CHECK_THAT(cur.nearest(-1, 2), IsEqualToArray<A>({0, 39}));
+  }
+
+  SECTION("Fields")
+  {
+    Field<double, 2> F(300, 40);
+    F.setCoordinateSystem([](size_t i, size_t N) { return 1e-4 * i * i; },
+                          Uniform(-1., 1.));
+    auto cur = F.cursor();
+    CHECK_THAT(cur.lower_bound(1, 0), IsEqualToArray<A>({100, 19}));
+    CHECK_THAT(cur.lower_bound(1.1, 0), IsEqualToArray<A>({104, 19}));
+  }
+}
+
+TEST_CASE("CoordinateSystem Lookup Cursor Performance", "[.][benchmarks]")
+{
+  // particles that move about a cell per step
+  const size_t                N = 1000000;
+  CoordinateSystem<double, 1> cs(N);
+  cs.set([](size_t i, size_t N) { return std::sqrt(1. * i / (N - 1)); });
+
+  std::mt19937                           gen(7);
+  std::uniform_real_distribution<double> dist(0, 1);
+  std::vector<double>                    x(1000);
+  for(auto& c : x) c = dist(gen);
+  std::vector<decltype(cs.cursor())> cursors(x.size(), cs.cursor());
+  const double                       dx = 1. / N;
+
+  BENCHMARK("lower_bound")
+  {
+    long sum = 0;
+    for(int s = 0; s < 100; ++s)
+      for(size_t i = 0; i < x.size(); ++i)
+        sum += cs.lower_bound(x[i] + s * dx)[0];
+    return sum;
+  };
+  BENCHMARK("Cursor")
+  {
+    long sum = 0;
+    for(int s = 0; s < 100; ++s)
+      for(size_t i = 0; i < x.size(); ++i)
+        sum += cursors[i].lower_bound(x[i] + s * dx)[0];
+    return sum;
+  };
+}
+
 TEST_CASE("getCoord Interface")
 {
   SECTION("1D Interface")
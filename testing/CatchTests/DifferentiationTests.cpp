@@ -0,0 +1,188 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <libField/Field.hpp>
+
+TEST_CASE("Finite Difference Derivatives")
+{
+  SECTION("1D")
+  {
+    Field<double, 1> f(20), df, d2f;
+    f.setCoordinateSystem([](size_t i, size_t N) { return 0.1 * i * i - 3; });
+    f.set_f([](auto x) { return 3 * x[0] * x[0] - 2 * x[0] + 1; });
+
+    // three point stencils are exact for quadratics, even at the boundaries
+    derivative(f, 0, df);
+    second_derivative(f, 0, d2f);
+    REQUIRE(df.size() == 20);
+    REQUIRE(d2f.size() == 20);
+    for(size_t i = 0; i < 20; ++i) {
+      auto x = f.getCoord(i);
+      CHECK(df(i) == Catch::Approx(6 * x - 2));
+      CHECK(d2f(i) == Catch::Approx(6));
+    }
+
+    derivative(f, 0, df, Boundary::Zero);
+    CHECK(df(0) == 0);
+    CHECK(df(19) == 0);
+    CHECK(df(1) == Catch::Approx(6 * f.getCoord(1) - 2));
+    CHECK(df(18) == Catch::Approx(6 * f.getCoord(18) - 2));
+
+    // the axis covers one period, without repeating the first point
+    const size_t N = 200;
+    Field<double, 1> s(N), ds;
+    s.setCoordinateSystem(Uniform(0., 2 * M_PI * (N - 1) / N));
+    s.set_f([](auto x) { return sin(x[0]); });
+    derivative(s, 0, ds, Boundary::Periodic);
+    for(size_t i = 0; i < N; ++i)
+      CHECK(ds(i) == Catch::Approx(cos(s.getCoord(i))).margin(1e-3));
+    second_derivative(s, 0, ds, Boundary::Periodic);
+    for(size_t i = 0; i < N; ++i)
+      CHECK(ds(i) == Catch::Approx(-sin(s.getCoord(i))).margin(1e-3));
+
+    // two points only give a straight line
+    Field<double, 1> t(2), dt;
+    t.setCoordinateSystem(Uniform(1., 3.));
+    t(0) = 1;
+    t(1) = 5;
+    derivative(t, 0, dt);
+    CHECK(dt(0) == Catch::Approx(2));
+    CHECK(dt(1) == Catch::Approx(2));
+  }
+
+  SECTION("1D split into segments")
+  {
+    Field<double, 1> f(10000), df;
+    f.setCoordinateSystem(Uniform(-1., 1.));
+    f.set_f([](auto x) { return x[0] * x[0]; });
+    derivative(f, 0, df);
+    for(size_t i = 0; i < f.size(); ++i)
+      CHECK(df(i) == Catch::Approx(2 * f.getCoord(i)).margin(1e-12));
+  }
+
+  SECTION("3D")
+  {
+    Field<double, 3> f(6, 7, 8), L;
+    f.setCoordinateSystem(Uniform(-1., 2.),
+                          [](size_t i, size_t N) { return 0.1 * i * i; },
+                          [](size_t i, size_t N) { return sqrt(1. * i); });
+    f.set_f([](auto x) {
+      return x[0] * x[0] + x[0] * x[1] + x[1] * x[2] * x[2];
+    });
+
+    // the stencils are exact, but the results can be round off instead of 0
+    auto approx = [](double v) { return Catch::Approx(v).margin(1e-12); };
+
+    std::array<Field<double, 3>, 3> grad;
+    gradient(f, grad);
+    laplacian(f, L);
+    for(size_t i = 0; i < f.size(0); ++i) {
+      for(size_t j = 0; j < f.size(1); ++j) {
+        for(size_t k = 0; k < f.size(2); ++k) {
+          auto x = f.getCoord(i, j, k);
+          CHECK(grad[0](i, j, k) == approx(2 * x[0] + x[1]));
+          CHECK(grad[1](i, j, k) == approx(x[0] + x[2] * x[2]));
+          CHECK(grad[2](i, j, k) == approx(2 * x[1] * x[2]));
+          CHECK(L(i, j, k) == approx(2 + 2 * x[1]));
+        }
+      }
+    }
+
+    // the derivative along one axis is the same component of the gradient
+    Field<double, 3> df;
+    for(size_t k = 0; k < 3; ++k) {
+      derivative(f, k, df);
+      for(size_t i = 0; i < f.size(); ++i)
+        CHECK(df.data()[i] == approx(grad[k].data()[i]));
+    }
+
+    std::array<Field<double, 3>, 3> v{{f, f, f}};
+    v[0].set_f([](auto x) { return x[0] * x[1]; });
+    v[1].set_f([](auto x) { return x[1] * x[2]; });
+    v[2].set_f([](auto x) { return x[2] * x[0]; });
+    Field<double, 3> div;
+    divergence(v, div);
+    for(size_t i = 0; i < f.size(0); ++i) {
+      for(size_t j = 0; j < f.size(1); ++j) {
+        for(size_t k = 0; k < f.size(2); ++k) {
+          auto x = f.getCoord(i, j, k);
+          CHECK(div(i, j, k) == approx(x[0] + x[1] + x[2]));
+        }
+      }
+    }
+  }
+
+  SECTION("Output with a different shape")
+  {
+    Field<double, 2> f(12, 9), df(9, 12);
+    f.setCoordinateSystem(Uniform(0., 1.), Uniform(-1., 1.));
+    f.set_f([](auto x) { return x[0] * x[1]; });
+    df = -1;
+    derivative(f, 0, df);
+    REQUIRE(df.size(0) == 12);
+    REQUIRE(df.size(1) == 9);
+    CHECK(df.getAxis(1)[8] == Catch::Approx(1));
+    for(size_t i = 0; i < 12; ++i)
+      for(size_t j = 0; j < 9; ++j)
+        CHECK(df(i, j) == Catch::Approx(f.getCoord(i, j)[1]));
+  }
+
+  SECTION("Tiled")
+  {
+    // large enough rows that the second axis is split into several tiles
+    Field<double, 3> f(20, 100, 2000), L;
+    f.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+    f.set_f([](auto x) { return x[0] * x[0] + x[1] * x[1] + x[2] * x[2]; });
+    laplacian(f, L, Boundary::Zero);
+    // check a few planes against the second derivative along each axis
+    for(int i : {0, 1, 10, 19}) {
+      for(int j : {0, 1, 17, 50, 99}) {
+        for(int k : {0, 1, 1000, 1999}) {
+          double expected = 0;
+          if(i > 0 && i < 19) expected += 2;
+          if(j > 0 && j < 99) expected += 2;
+          if(k > 0 && k < 1999) expected += 2;
+          CHECK(L(i, j, k) == Catch::Approx(expected).margin(1e-4));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Finite Difference Derivatives Performance", "[.][benchmarks]")
+{
+  const int        N = 200;
+  Field<double, 3> T(N, N, N), L(T);
+  T.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+  T.set_f([](auto x) { return x[0] * x[1] * x[2]; });
+  const double dx = T.getAxis(0)[1] - T.getAxis(0)[0];
+
+  BENCHMARK("Loop")
+  {
+    for(int i = 1; i < N - 1; ++i) {
+      for(int j = 1; j < N - 1; ++j) {
+        for(int k = 1; k < N - 1; ++k) {
+          L(i, j, k) = (T(i + 1, j, k) + T(i - 1, j, k) + T(i, j + 1, k) +
+                        T(i, j - 1, k) + T(i, j, k + 1) + T(i, j, k - 1) -
+                        6 * T(i, j, k)) /
+                       (dx * dx);
+        }
+      }
+    }
+    return L(1, 1, 1);
+  };
+  BENCHMARK("laplacian")
+  {
+    laplacian(T, L);
+    return L(1, 1, 1);
+  };
+
+  std::array<Field<double, 3>, 3> grad;
+  BENCHMARK("gradient")
+  {
+    gradient(T, grad);
+    return grad[0](1, 1, 1);
+  };
+}
@@ -0,0 +1,135 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libField/Field.hpp>
+
+#include "Utils.h"
+
+TEST_CASE("Field Expressions")
+{
+  Field<double, 2> A(3, 4), B(A), C(A), D(A);
+  A.setCoordinateSystem(Uniform(0., 2.), Uniform(0., 3.));
+  A.set_f([](auto x) { return x[0] + 1; });
+  B.set_f([](auto i, auto cs) { return i[1] + 1.; });
+  C = 2.0;
+  D = 4.0;
+
+  SECTION("Binary operators")
+  {
+    Field<double, 2> T(3, 4);
+    T = 2 * A + C / D;
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++)
+        CHECK(T(i, j) == Catch::Approx(2 * (i + 1) + 0.5));
+
+    T = A * B - 1.0;
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++)
+        CHECK(T(i, j) == Catch::Approx((i + 1) * (j + 1) - 1.0));
+
+    T = (A + B) / (C - 1);
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++) CHECK(T(i, j) == Catch::Approx(i + j + 2.));
+  }
+
+  SECTION("Unary operators")
+  {
+    Field<double, 2> T(3, 4);
+    T = -A + sqrt(D) * exp(C - 2) + abs(-B) + log(exp(C)) * cos(0 * A) +
+        sin(0 * A);
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++)
+        CHECK(T(i, j) == Catch::Approx(-(i + 1.) + 2 + (j + 1) + 2));
+  }
+
+  SECTION("Compound assignment")
+  {
+    Field<double, 2> T(3, 4);
+    T = 1.0;
+    T += A * B;
+    T -= 2 * C;
+    T *= D / C;
+    T /= C * C;
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++)
+        CHECK(T(i, j) == Catch::Approx((1. + (i + 1) * (j + 1) - 4) / 2));
+  }
+
+  SECTION("Field appears on both sides")
+  {
+    A = A * A + A;
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++)
+        CHECK(A(i, j) == Catch::Approx((i + 1) * (i + 1) + (i + 1)));
+  }
+
+  SECTION("Construct from expression")
+  {
+    Field<double, 2> T = A + B;
+    CHECK(T.size(0) == 3);
+    CHECK(T.size(1) == 4);
+    CHECK(T.getCoord(2, 3)[0] == Catch::Approx(2));
+    CHECK(T.getCoord(2, 3)[1] == Catch::Approx(3));
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++) CHECK(T(i, j) == Catch::Approx(i + j + 2.));
+
+    // coordinate system is a copy
+    T.getAxis(0)[0] = -1;
+    CHECK(A.getAxis(0)[0] == Catch::Approx(0));
+
+    Field<double, 2> U;
+    U = 3 * B;
+    CHECK(U.size() == 12);
+    for(int i = 0; i < 3; i++)
+      for(int j = 0; j < 4; j++) CHECK(U(i, j) == Catch::Approx(3 * (j + 1.)));
+  }
+
+  SECTION("Sliced fields")
+  {
+    Field<double, 2> T(3, 4);
+    T = 0.0;
+    auto S = T.slice(indices[IRange()][IRange(0, 4, 2)]);
+    auto a = A.slice(indices[IRange()][IRange(1, 4, 2)]);
+    S = a * a + 1;
+    for(int i = 0; i < 3; i++) {
+      CHECK(T(i, 0) == Catch::Approx((i + 1) * (i + 1) + 1));
+      CHECK(T(i, 1) == Catch::Approx(0));
+      CHECK(T(i, 2) == Catch::Approx((i + 1) * (i + 1) + 1));
+      CHECK(T(i, 3) == Catch::Approx(0));
+    }
+  }
+}
+
+TEST_CASE("Field Expressions vs. Compound Operators", "[.][benchmarks]")
+{
+  Field<double, 3> T(200, 200, 200), A(T), B(T), C(T), D(T);
+  A = 1.0;
+  B = 2.0;
+  C = 3.0;
+  D = 4.0;
+
+  BENCHMARK("Compound Operators")
+  {
+    Field<double, 3> tmp(C);
+    tmp /= D;
+    T = B;
+    T *= 2.0;
+    T += tmp;
+    return T.size();
+  };
+
+  BENCHMARK("Expression") { return (T = 2.0 * B + C / D).size(); };
+
+  BENCHMARK("Raw Loop")
+  {
+    auto   t = T.data();
+    auto   b = B.data();
+    auto   c = C.data();
+    auto   d = D.data();
+    size_t N = T.size();
+#pragma omp parallel for
+    for(size_t i = 0; i < N; ++i) t[i] = 2.0 * b[i] + c[i] / d[i];
+    return t[0];
+  };
+}
@@ -2,7 +2,14 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <iterator>
 #include <libField/Field.hpp>
+#include <numeric>
+#include <random>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "Utils.h"
 
@@ -160,6 +167,43 @@ TEST_CASE("Field Operators")
     for(int j = 0; j < 3; j++) CHECK(T[i][j] == Catch::Approx(3.0));
 }
 
+TEST_CASE("Field Operators on Slices")
+{
+  Field<double, 3> F(4, 5, 6);
+  F.setCoordinateSystem(Uniform(0., 3.), Uniform(0., 4.), Uniform(0., 5.));
+  F = 1.0;
+
+  // slices are strided views into F, so they can't be traversed linearly.
+  auto S1 = F.slice(indices[IRange()][1][IRange(0, 6, 2)]);
+  auto S2 = F.slice(indices[IRange()][3][IRange(1, 6, 2)]);
+  CHECK(S1.size() == 12);
+
+  S1 = 2.0;
+  S1 *= 3.0;
+  S1 -= 1.0;
+  S2.set(4.0);
+  S2 /= 2.0;
+  S2 += S1;
+
+  for(int i = 0; i < 4; i++) {
+    for(int j = 0; j < 5; j++) {
+      for(int k = 0; k < 6; k++) {
+        if(j == 1 && k % 2 == 0)
+          CHECK(F(i, j, k) == Catch::Approx(5.0));
+        else if(j == 3 && k % 2 == 1)
+          CHECK(F(i, j, k) == Catch::Approx(7.0));
+        else
+          CHECK(F(i, j, k) == Catch::Approx(1.0));
+      }
+    }
+  }
+
+  S2.set_f([](auto x) { return x[0] + 10 * x[1]; });
+  for(int i = 0; i < 4; i++)
+    for(int k = 0; k < 3; k++)
+      CHECK(F(i, 3, 2 * k + 1) == Catch::Approx(i + 10 * (2 * k + 1)));
+}
+
 TEST_CASE("Field Slicing")
 {
   int              Nx = 6, Ny = 6, Nz = 6;
@@ -204,6 +248,68 @@ TEST_CASE("Field Slicing")
   CHECK(F2.getAxis(1)[0] == 1);
   CHECK(F2.getAxis(1)[1] == 3);
   CHECK(F2.getAxis(1)[2] == 5);
+
+  // slices refer to the field's coordinates, and keep the field alive
+  CHECK(&F2.getAxis(0)[0] == &F1.getAxis(0)[0]);
+  CHECK(&F2.getAxis(1)[0] == &F1.getAxis(2)[1]);
+  CHECK(F2.getCoord(4, 1)[1] == Catch::Approx(3));
+  auto S = Field<double, 3>(F1).slice(indices[3][IRange()][IRange(0, 6, 5)]);
+  CHECK(S.size(0) == 6);
+  CHECK(S.size(1) == 2);
+  CHECK(S(4, 1) == 3 * 4 * 5);
+  CHECK(S.getAxis(1)[1] == 5);
+  auto S2 = S.slice(indices[IRange(1, 5, 2)][1]);
+  CHECK(S2.size() == 2);
+  CHECK(S2(1) == 3 * 3 * 5);
+  CHECK(S2.getAxis(0)[1] == 3);
+
+  // copies of a slice share its state, and keep the field alive too
+  Field<double, 1, double, viewND, view1D> S3;
+  {
+    Field<double, 2> G(3, 4);
+    G.setCoordinateSystem(Uniform(0, 2), Uniform(0, 3));
+    G.set_f([](auto x) { return x[0] + 10 * x[1]; });
+    auto S4 = G.slice(indices[IRange()][2]);
+    S3      = S4;
+    auto S5 = S4.clone();
+    CHECK(std::is_same<decltype(S5), Field<double, 1, double>>::value);
+    CHECK(&S5(1) != &S4(1));
+    CHECK(S5(1) == S4(1));
+    CHECK(&S5.getAxis(0)[1] != &S4.getAxis(0)[1]);
+    CHECK(S5.getAxis(0)[1] == 1);
+    S5(1) = -1;
+    CHECK(S4(1) == 1 + 10 * 2);
+  }
+  CHECK(S3.size() == 3);
+  CHECK(S3(2) == 2 + 10 * 2);
+  CHECK(S3.getAxis(0)[2] == 2);
+
+  // axis pointers and coordinate systems taken from a slice outlive it
+  Field<double, 2> G(3, 4);
+  G.setCoordinateSystem(Uniform(0, 2), Uniform(0, 3));
+  auto ax = [&] {
+    auto S6 = G.slice(indices[IRange()][2]);
+    return S6.getCoordinateSystem().getAxisPtr(0);
+  }();
+  auto cs = [&] {
+    auto S6 = G.slice(indices[1][IRange()]);
+    return S6.getCoordinateSystem();
+  }();
+  CHECK((*ax)[2] == 2);
+  CHECK(cs[0][3] == 3);
+  CHECK(cs.getAxes()[0]->size() == 4);
+}
+
+TEST_CASE("Field Slicing Performance", "[.][benchmarks]")
+{
+  Field<double, 3> F(100, 100, 100);
+  F = 1.;
+
+  BENCHMARK("line-out") { return F.slice(indices[50][IRange()][50]).size(); };
+  BENCHMARK("plane")
+  {
+    return F.slice(indices[IRange()][50][IRange()]).size();
+  };
 }
 
 TEST_CASE("Field Output Operator")
@@ -403,15 +509,312 @@ TEST_CASE("Field Semantics")
   }
 }
 
+TEST_CASE("Field Copy-on-Write")
+{
+  Field<double, 2> a(10, 20);
+  a.setCoordinateSystem(Uniform(0, 1), Uniform(0, 2));
+  a = 1.0;
+  a.setCopyOnWrite();
+  const auto&   ca     = a;
+  const double* a_data = ca.getData().data();
+
+  SECTION("Copies share storage until modified")
+  {
+    Field<double, 2> b(a);
+    CHECK(b.getCopyOnWrite());
+    const auto& cb = b;
+    CHECK(cb.getData().data() == a_data);
+    CHECK(&cb.getCoordinateSystem() == &ca.getCoordinateSystem());
+    CHECK(cb(2, 3) == 1.0);
+
+    b += 1.0;
+    CHECK(cb.getData().data() != a_data);
+    CHECK(b(2, 3) == 2.0);
+    CHECK(a(2, 3) == 1.0);
+    // only the elements were detached
+    CHECK(&cb.getCoordinateSystem() == &ca.getCoordinateSystem());
+
+    b.getAxis(0)[9] = 100;
+    CHECK(b.getAxis(0)[9] == 100);
+    CHECK(a.getAxis(0)[9] == Catch::Approx(1));
+
+    // a is not shared anymore, so writing does not copy
+    a(0, 0) = 3;
+    CHECK(ca.getData().data() == a_data);
+  }
+
+  SECTION("Writing to the original detaches it")
+  {
+    Field<double, 2> b;
+    b = a;
+    const auto& cb = b;
+    a[1][1] = 5;
+    CHECK(a(1, 1) == 5);
+    CHECK(cb(1, 1) == 1);
+    CHECK(cb.getData().data() == a_data);
+
+    a.setCoordinateSystem(Uniform(-1, 1), Uniform(-2, 2));
+    CHECK(a.getAxis(0)[0] == Catch::Approx(-1));
+    CHECK(b.getAxis(0)[0] == Catch::Approx(0));
+  }
+
+  SECTION("Field operations detach")
+  {
+    Field<double, 2> b(a), c(a), e(a);
+    b.set_f([](auto x) { return x[0]; });
+    c = a * a + 1;
+    auto s = e.slice(indices[IRange()][3]);
+    s = 7.0;
+    for(int i = 0; i < 10; ++i)
+      for(int j = 0; j < 20; ++j) {
+        CHECK(a(i, j) == 1.0);
+        CHECK(b(i, j) == Catch::Approx(i / 9.));
+        CHECK(c(i, j) == 2.0);
+        CHECK(e(i, j) == (j == 3 ? 7.0 : 1.0));
+      }
+  }
+
+  SECTION("Slices are not copies")
+  {
+    auto s = a.slice(indices[1][IRange()]);
+    a(1, 3) = 7;
+    CHECK(s(3) == 7);
+    CHECK(ca.getData().data() == a_data);
+
+    Field<double, 2> b(a);
+    auto             t = b.slice(indices[IRange()][2]);
+    b(4, 2)            = 8;
+    CHECK(t(4) == 8);
+    CHECK(a(4, 2) == 1.0);
+    t(5) = 9;
+    CHECK(b(5, 2) == 9);
+    CHECK(a(5, 2) == 1.0);
+  }
+
+  SECTION("Clone is a deep copy")
+  {
+    const auto b = a.clone();
+    CHECK(b.getData().data() != a_data);
+    CHECK(&b.getCoordinateSystem() != &ca.getCoordinateSystem());
+    CHECK(b(4, 5) == 1.0);
+  }
+
+  SECTION("Disabled by default")
+  {
+    Field<double, 2> b(10, 20);
+    CHECK(!b.getCopyOnWrite());
+    Field<double, 2> c(b);
+    CHECK(c.getData().data() != b.getData().data());
+  }
+}
+
+TEST_CASE("Field::reset Reuses Storage")
+{
+  Field<double, 2> F(10, 20);
+  const auto&      cF = F;
+  F.setCoordinateSystem(Uniform(0, 1), Uniform(0, 2));
+  const double* data = cF.getData().data();
+  const double* axis = cF.getAxis(0).data();
+
+  SECTION("Same shape")
+  {
+    F.reset(10, 20);
+    CHECK(cF.getData().data() == data);
+    CHECK(cF.getAxis(0).data() == axis);
+    CHECK(F.size(0) == 10);
+    CHECK(F.size(1) == 20);
+  }
+
+  SECTION("Same number of elements")
+  {
+    F.reset(std::array<int, 2>{20, 10});
+    CHECK(cF.getData().data() == data);
+    CHECK(F.size(0) == 20);
+    CHECK(F.size(1) == 10);
+    CHECK(F.getAxis(0).size() == 20);
+    CHECK(F.getAxis(1).size() == 10);
+    F(19, 9) = 1;
+    CHECK(cF.getData().data()[199] == 1);
+  }
+
+  SECTION("Different number of elements")
+  {
+    F.reset(10, 21);
+    CHECK(F.size() == 210);
+    CHECK(F.getAxis(1).size() == 21);
+  }
+
+  SECTION("Shared storage is not reused")
+  {
+    F = 2.0;
+    auto d  = F.getDataPtr();
+    auto cs = F.getCoordinateSystemPtr();
+    F.reset(10, 20);
+    CHECK(cF.getData().data() != data);
+    CHECK(&cF.getCoordinateSystem() != cs.get());
+    CHECK((*d)[9][19] == 2.0);
+    CHECK(cs->getAxis(0)[9] == Catch::Approx(1));
+  }
+
+  SECTION("From a coordinate system")
+  {
+    auto cs = std::make_shared<Field<double, 2>::cs_type>(20, 10);
+    F.reset(cs);
+    CHECK(cF.getData().data() == data);
+    CHECK(&cF.getCoordinateSystem() == cs.get());
+    CHECK(F.size(0) == 20);
+  }
+}
+
 TEST_CASE("Field Copy vs. Move", "[.][benchmarks]")
 {
   Field<double, 3> F1(100, 100, 100);
 
   BENCHMARK("Field Copy") { Field<double, 3> F2(F1); };
 
+  Field<double, 3> F3(F1);
+  F3.setCopyOnWrite();
+  BENCHMARK("Field Copy (copy-on-write)")
+  {
+    Field<double, 3> F2(F3);
+    return F2.size();
+  };
+
   BENCHMARK("Field Move") { Field<double, 3> F2(std::move(F1)); };
 }
 
+TEST_CASE("Field Operators: Contiguous vs. Strided", "[.][benchmarks]")
+{
+  Field<double, 3> F1(200, 200, 200), F2(200, 200, 200);
+  F1 = 1.0;
+  F2 = 2.0;
+  auto S1 = F1.slice(indices[IRange()][IRange()][IRange()]);
+  auto S2 = F2.slice(indices[IRange()][IRange()][IRange()]);
+
+  BENCHMARK("Raw Loop")
+  {
+    auto   p = F1.data();
+    auto   q = F2.data();
+    size_t N = F1.size();
+#pragma omp parallel for
+    for(size_t i = 0; i < N; ++i) p[i] += q[i];
+    return p[0];
+  };
+
+  BENCHMARK("Contiguous Field += Scalar") { return (F1 += 2.0).size(); };
+  BENCHMARK("Strided View += Scalar") { return (S1 += 2.0).size(); };
+  BENCHMARK("Contiguous Field += Field") { return (F1 += F2).size(); };
+  BENCHMARK("Strided View += Field") { return (S1 += S2).size(); };
+}
+
+TEST_CASE("Field::points")
+{
+  Field<double, 2> F(4, 6);
+  F.setCoordinateSystem(Uniform(0., 3.),
+                        [](size_t i, size_t N) { return 0.5 * i * i; });
+
+  auto P = F.points();
+  CHECK(P.size() == 24);
+  CHECK(std::distance(P.begin(), P.end()) == 24);
+  static_assert(
+      std::is_same<std::iterator_traits<decltype(P.begin())>::iterator_category,
+                   std::random_access_iterator_tag>::value,
+      "points are random access");
+
+  for(auto p : F.points()) p.value() = p.coord(0) + 10 * p.coord(1);
+  for(size_t i = 0; i < 4; ++i)
+    for(size_t j = 0; j < 6; ++j)
+      CHECK(F(i, j) == Catch::Approx(i + 5. * j * j));
+
+  SECTION("Random access")
+  {
+    auto b = P.begin();
+    auto p = b[13];
+    CHECK(p.index()[0] == 2);
+    CHECK(p.index()[1] == 1);
+    CHECK(p.coord()[1] == Catch::Approx(0.5));
+    CHECK(&p.value() == &F(2, 1));
+    CHECK((*(b + 13)).index() == p.index());
+    CHECK((*(P.end() - 1)).index()[1] == 5);
+    auto it = b + 5;
+    ++it;
+    CHECK((*it).index()[0] == 1);
+    CHECK((*it).index()[1] == 0);
+    --it;
+    CHECK((*it).index()[0] == 0);
+    CHECK((*it).index()[1] == 5);
+    CHECK(it - b == 5);
+    CHECK(b < it);
+    CHECK(P[23].index()[0] == 3);
+  }
+
+  SECTION("Tuples")
+  {
+    auto p = P[7];
+    CHECK(p.get<0>()[1] == 1);
+    CHECK(p.get<1>()[0] == Catch::Approx(1));
+    p.get<2>() = -1;
+    CHECK(F(1, 1) == -1);
+    CHECK(std::tuple_size<decltype(p)>::value == 3);
+  }
+
+  SECTION("Standard algorithms")
+  {
+    const Field<double, 2>& C = F;
+    double s = std::accumulate(
+        C.points().begin(), C.points().end(), 0.,
+        [](double s, auto p) { return s + p.value() * p.coord(0); });
+    double t = 0;
+    for(size_t i = 0; i < 4; ++i)
+      for(size_t j = 0; j < 6; ++j) t += F(i, j) * i;
+    CHECK(s == Catch::Approx(t));
+
+    std::vector<double> r(P.size());
+    std::transform(P.begin(), P.end(), r.begin(),
+                   [](auto p) { return p.coord(1); });
+    CHECK(r[11] == Catch::Approx(12.5));
+
+    std::for_each(P.begin(), P.end(), [](auto p) { p.value() = 1; });
+    CHECK(F.sum() == Catch::Approx(24));
+  }
+
+  SECTION("Slices")
+  {
+    auto S = F.slice(indices[IRange(1, 4, 2)][IRange(0, 6, 3)]);
+    size_t n = 0;
+    for(auto p : S.points()) {
+      CHECK(&p.value() == &F(1 + 2 * p.index()[0], 3 * p.index()[1]));
+      CHECK(p.coord(1) == Catch::Approx(4.5 * p.index()[1]));
+      ++n;
+    }
+    CHECK(n == 4);
+  }
+
+  SECTION("Empty fields")
+  {
+    Field<double, 2> E(0, 0), E2(3, 0);
+    size_t           n = 0;
+    for(auto p : E.points()) n += p.index()[0];
+    for(auto p : E2.points()) n += p.index()[0];
+    CHECK(n == 0);
+    CHECK(E.points().begin() == E.points().end());
+    CHECK(E2.points().size() == 0);
+  }
+}
+
+TEST_CASE("Field::points Performance", "[.][benchmarks]")
+{
+  Field<double, 3> F(100, 100, 100);
+  F.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+
+  BENCHMARK("set_f") { F.set_f([](auto x) { return x[0] * x[1] + x[2]; }); };
+  BENCHMARK("points")
+  {
+    for(auto p : F.points())
+      p.value() = p.coord(0) * p.coord(1) + p.coord(2);
+  };
+}
+
 #include <boost/optional.hpp>
 TEST_CASE("Field::set_f")
 {
@@ -512,4 +915,794 @@ TEST_CASE("Field::set_f")
       CHECK(F(10, 5) == Catch::Approx(-1));
     }
   }
+
+  SECTION("3D")
+  {
+    // large enough to be split into several blocks
+    Field<double, 3> F(17, 19, 23);
+    F.setCoordinateSystem(Uniform(0, 1), Geometric(0., 1., 1.1),
+                          Uniform(-2, 2));
+
+    SECTION("1 arg signature")
+    {
+      F.set_f([](auto x) { return x[0] + 10 * x[1] + 100 * x[2]; });
+
+      for(int i = 0; i < 17; ++i) {
+        for(int j = 0; j < 19; ++j) {
+          for(int k = 0; k < 23; ++k) {
+            auto x = F.getCoord(i, j, k);
+            CHECK(F(i, j, k) == Catch::Approx(x[0] + 10 * x[1] + 100 * x[2]));
+          }
+        }
+      }
+    }
+
+    SECTION("2 arg signature")
+    {
+      F.set_f([](auto ind, auto cs) {
+        return ind[0] + 100. * ind[1] + 10000. * ind[2];
+      });
+
+      for(int i = 0; i < 17; ++i)
+        for(int j = 0; j < 19; ++j)
+          for(int k = 0; k < 23; ++k)
+            CHECK(F(i, j, k) == i + 100. * j + 10000. * k);
+    }
+  }
+}
+
+TEST_CASE("Field::update_f")
+{
+  // large enough to be split into several blocks
+  Field<double, 2> F(101, 53);
+  F.setCoordinateSystem(Uniform(0, 10), Geometric(0., 1., 1.1));
+  F.set_f([](auto x) { return x[0] + x[1]; });
+  auto expected = [&](int i, int j) {
+    auto x = F.getCoord(i, j);
+    return x[0] + x[1];
+  };
+
+  SECTION("coordinates and value")
+  {
+    F.update_f([](auto x, double v) { return v * x[0]; });
+    for(int i = 0; i < 101; ++i)
+      for(int j = 0; j < 53; ++j)
+        CHECK(F(i, j) == Catch::Approx(expected(i, j) * F.getCoord(i, j)[0]));
+  }
+
+  SECTION("coordinates and value with optional return")
+  {
+    F.update_f([](auto x, const double& v) -> boost::optional<double> {
+      if(x[0] < 5) return -v;
+      return boost::none;
+    });
+    CHECK(F(0, 3) == Catch::Approx(-expected(0, 3)));
+    CHECK(F(49, 52) == Catch::Approx(-expected(49, 52)));
+    CHECK(F(50, 52) == Catch::Approx(expected(50, 52)));
+    CHECK(F(100, 0) == Catch::Approx(expected(100, 0)));
+  }
+
+  SECTION("coordinates and reference")
+  {
+    F.update_f([](auto x, double& v) { v += 2 * x[1]; });
+    for(int i = 0; i < 101; ++i)
+      for(int j = 0; j < 53; ++j)
+        CHECK(F(i, j) ==
+              Catch::Approx(expected(i, j) + 2 * F.getCoord(i, j)[1]));
+  }
+
+  SECTION("indices and value")
+  {
+    F.update_f([](auto ind, auto cs, double v) { return v + ind[0] * ind[1]; });
+    CHECK(F(3, 7) == Catch::Approx(expected(3, 7) + 21));
+    CHECK(F(100, 52) == Catch::Approx(expected(100, 52) + 5200));
+  }
+
+  SECTION("indices and value with optional return")
+  {
+    F.update_f([](auto ind, auto cs, double v) -> boost::optional<double> {
+      if(ind[1] == 0) return 0.;
+      return boost::none;
+    });
+    CHECK(F(3, 0) == 0);
+    CHECK(F(3, 1) == Catch::Approx(expected(3, 1)));
+  }
+
+  SECTION("indices and reference")
+  {
+    F.update_f([](auto ind, auto cs, double& v) { v *= cs->getCoord(ind)[0]; });
+    CHECK(F(20, 4) == Catch::Approx(expected(20, 4) * 2));
+  }
+
+  SECTION("slices")
+  {
+    auto S = F.slice(indices[IRange(0, 101, 10)][2]);
+    S.update_f([](auto x, double& v) { v = -x[0]; });
+    CHECK(F(10, 2) == Catch::Approx(-1));
+    CHECK(F(11, 2) == Catch::Approx(expected(11, 2)));
+  }
+}
+
+TEST_CASE("Field::update_f Performance", "[.][benchmarks]")
+{
+  Field<double, 3> F(100, 100, 100);
+  F.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+  F = 1.;
+
+  BENCHMARK("temporary field and *=")
+  {
+    Field<double, 3> A(F.getCoordinateSystemPtr());
+    A.set_f([](auto x) { return 1 - 1e-3 * x[2]; });
+    F *= A;
+  };
+  BENCHMARK("update_f")
+  {
+    F.update_f([](auto x, double v) { return v * (1 - 1e-3 * x[2]); });
+  };
+}
+
+TEST_CASE("Field::set_f_batched")
+{
+  auto gaussian = [](double x, double y) { return exp(-x * x - 2 * y * y); };
+
+  SECTION("Contiguous field")
+  {
+    // 101 x 103 is not a multiple of the block size
+    Field<double, 2> F(101, 103), G(101, 103);
+    F.setCoordinateSystem(Uniform(-1., 1.), Geometric(-1., 0.01, 1.02));
+    G.setCoordinateSystem(Uniform(-1., 1.), Geometric(-1., 0.01, 1.02));
+
+    // the callable runs on several threads, so it only counts the blocks
+    // whose sizes do not match, and the count is checked afterwards
+    size_t calls = 0, mismatched = 0;
+    F.set_f_batched([&](const auto& x, auto out) {
+#pragma omp atomic
+      ++calls;
+      if(x[0].size() != out.size() || x[1].size() != out.size()) {
+#pragma omp atomic
+        ++mismatched;
+      }
+      for(size_t k = 0; k < out.size(); ++k) out[k] = gaussian(x[0][k], x[1][k]);
+    });
+    G.set_f([&](auto x) { return gaussian(x[0], x[1]); });
+
+    CHECK(calls > 1);
+    CHECK(mismatched == 0);
+    for(int i = 0; i < 101; ++i)
+      for(int j = 0; j < 103; ++j) CHECK(F(i, j) == G(i, j));
+  }
+
+  SECTION("Sliced field")
+  {
+    Field<double, 2> F(10, 20);
+    F.setCoordinateSystem(Uniform(0., 9.), Uniform(0., 19.));
+    F = -1.0;
+    auto S = F.slice(indices[IRange(1, 9)][IRange(0, 20, 3)]);
+    S.set_f_batched([](const auto& x, auto out) {
+      for(size_t k = 0; k < out.size(); ++k) out[k] = x[0][k] + 100 * x[1][k];
+    });
+    for(int i = 0; i < 10; ++i)
+      for(int j = 0; j < 20; ++j) {
+        if(i >= 1 && i < 9 && j % 3 == 0)
+          CHECK(F(i, j) == Catch::Approx(i + 100. * j));
+        else
+          CHECK(F(i, j) == -1.0);
+      }
+  }
+}
+
+TEST_CASE("Field::interp")
+{
+  SECTION("1D")
+  {
+    Field<double, 1> F(11);
+    F.setCoordinateSystem(Geometric(0., 0.1, 1.2));
+    F.set_f([](auto x) { return 2 * x[0] + 1; });
+    double xmax = F.getAxis(0)[10];
+
+    CHECK(F.interp(0.) == Catch::Approx(1));
+    CHECK(F.interp(0.05) == Catch::Approx(1.1));
+    CHECK(F.interp(1.234) == Catch::Approx(3.468));
+    CHECK(F.interp(xmax) == Catch::Approx(2 * xmax + 1));
+    // out of range coordinates are clamped
+    CHECK(F.interp(-1.) == Catch::Approx(1));
+    CHECK(F.interp(xmax + 1) == Catch::Approx(2 * xmax + 1));
+  }
+
+  SECTION("2D")
+  {
+    Field<double, 2> F(5, 8);
+    F.setCoordinateSystem(Uniform(-1., 1.), Geometric(0., 0.1, 1.5));
+    // bilinear functions are interpolated exactly
+    auto f = [](double x, double y) { return 1 + 2 * x - 3 * y + 4 * x * y; };
+    F.set_f([&](auto x) { return f(x[0], x[1]); });
+
+    CHECK(F.interp(-1., 0.) == Catch::Approx(f(-1, 0)));
+    CHECK(F.interp(0.3, 0.7) == Catch::Approx(f(0.3, 0.7)));
+    CHECK(F.interp(std::array<double, 2>{-0.9, 1.1}) ==
+          Catch::Approx(f(-0.9, 1.1)));
+    CHECK(F.interp(2., 0.7) == Catch::Approx(f(1, 0.7)));
+  }
+
+  SECTION("3D")
+  {
+    Field<double, 3> F(7, 9, 4);
+    F.setCoordinateSystem(Uniform(0., 6.), Geometric(-1., 0.1, 1.3),
+                          Uniform(0., 1.));
+    auto f = [](double x, double y, double z) {
+      return x * y * z + x - y + 2 * z + 0.5;
+    };
+    F.set_f([&](auto x) { return f(x[0], x[1], x[2]); });
+
+    for(double x : {0., 0.3, 2.5, 6.})
+      for(double y : {-1., -0.95, 0., 1.})
+        for(double z : {0., 0.1, 0.9, 1.})
+          CHECK(F.interp(x, y, z) == Catch::Approx(f(x, y, z)));
+
+    // single point axes
+    Field<double, 3> G(3, 1, 2);
+    G.setCoordinateSystem(Uniform(0., 2.), Uniform(5., 5.), Uniform(0., 1.));
+    G.set_f([](auto x) { return x[0] + 10 * x[2]; });
+    CHECK(G.interp(1.5, 3., 0.5) == Catch::Approx(6.5));
+  }
+
+  SECTION("Sliced fields")
+  {
+    Field<double, 2> F(5, 8);
+    F.setCoordinateSystem(Uniform(0., 4.), Uniform(0., 7.));
+    F.set_f([](auto x) { return x[0] + 10 * x[1]; });
+    auto S = F.slice(indices[IRange(1, 5, 2)][IRange()]);
+    CHECK(S.interp(2., 2.5) == Catch::Approx(27));
+  }
+
+  SECTION("Batched")
+  {
+    Field<double, 2> F(50, 80);
+    F.setCoordinateSystem(Uniform(-1., 1.), Geometric(0., 0.01, 1.05));
+    F.set_f([](auto x) { return sin(3 * x[0]) * cos(x[1]); });
+
+    // a spiral track, out of range at both ends
+    std::vector<std::array<double, 2>> points;
+    for(int i = 0; i < 10000; ++i) {
+      double t = i * 1e-3;
+      points.push_back({0.12 * t * cos(t), 0.5 * t * sin(t) + 1});
+    }
+    auto v = F.interp_batched(points);
+    REQUIRE(v.size() == points.size());
+    for(size_t i = 0; i < points.size(); ++i)
+      CHECK(v[i] == F.interp(points[i]));
+  }
+}
+
+TEST_CASE("Field::interp Performance", "[.][benchmarks]")
+{
+  Field<double, 3> F(100, 100, 100);
+  F.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+  F.set_f([](auto x) { return x[0] * x[1] * x[2]; });
+
+  // points along a particle track
+  std::vector<std::array<double, 3>> points(1000000);
+  for(size_t i = 0; i < points.size(); ++i) {
+    double t  = 1. * i / points.size();
+    points[i] = {t, 0.5 + 0.4 * sin(10 * t), 0.5 + 0.4 * cos(10 * t)};
+  }
+
+  BENCHMARK("Hand-rolled with lower_bound")
+  {
+    double sum = 0;
+    for(auto& p : points) {
+      auto   i  = F.lower_bound(p[0], p[1], p[2]);
+      double tx = (p[0] - F.getAxis(0)[i[0]]) /
+                  (F.getAxis(0)[i[0] + 1] - F.getAxis(0)[i[0]]);
+      double ty = (p[1] - F.getAxis(1)[i[1]]) /
+                  (F.getAxis(1)[i[1] + 1] - F.getAxis(1)[i[1]]);
+      double tz = (p[2] - F.getAxis(2)[i[2]]) /
+                  (F.getAxis(2)[i[2] + 1] - F.getAxis(2)[i[2]]);
+      double v  = 0;
+      for(int a = 0; a < 2; ++a)
+        for(int b = 0; b < 2; ++b)
+          for(int c = 0; c < 2; ++c)
+            v += (a ? tx : 1 - tx) * (b ? ty : 1 - ty) * (c ? tz : 1 - tz) *
+                 F(i[0] + a, i[1] + b, i[2] + c);
+      sum += v;
+    }
+    return sum;
+  };
+
+  BENCHMARK("interp")
+  {
+    double sum = 0;
+    for(auto& p : points) sum += F.interp(p);
+    return sum;
+  };
+
+  BENCHMARK("interp_batched") { return F.interp_batched(points).size(); };
+}
+
+TEST_CASE("Field::set_f Coordinates", "[.][benchmarks]")
+{
+  Field<double, 3> F(200, 200, 200);
+  F.setCoordinateSystem(Uniform(-1., 1.), Uniform(-1., 1.), Uniform(-1., 1.));
+
+  BENCHMARK("set_f(coordinates)")
+  {
+    F.set_f([](auto x) { return x[0] * x[1] * x[2]; });
+    return F.size();
+  };
+
+  BENCHMARK("set_f(indices, cs) with getCoord")
+  {
+    F.set_f([](auto ind, auto cs) {
+      auto x = cs->getCoord(ind);
+      return x[0] * x[1] * x[2];
+    });
+    return F.size();
+  };
+
+  BENCHMARK("set_f(coordinates) Gaussian")
+  {
+    F.set_f([](auto x) { return exp(-x[0] * x[0] - x[1] * x[1] - x[2] * x[2]); });
+    return F.size();
+  };
+
+  BENCHMARK("set_f_batched Gaussian")
+  {
+    F.set_f_batched([](const auto& x, auto out) {
+      for(size_t k = 0; k < out.size(); ++k)
+        out[k] = exp(-x[0][k] * x[0][k] - x[1][k] * x[1][k] - x[2][k] * x[2][k]);
+    });
+    return F.size();
+  };
+
+  BENCHMARK("Loop with getCoord")
+  {
+    for(int i = 0; i < 200; ++i)
+      for(int j = 0; j < 200; ++j)
+        for(int k = 0; k < 200; ++k) {
+          auto x     = F.getCoord(i, j, k);
+          F[i][j][k] = x[0] * x[1] * x[2];
+        }
+    return F.size();
+  };
+}
+
+TEST_CASE("Field Reductions")
+{
+  Field<double, 2> F(150, 101);
+  F.setCoordinateSystem(Uniform(0., 1.49), Uniform(-1., 1.));
+  F.set_f([](auto x) { return std::sin(10 * x[0]) + x[1]; });
+
+  double sum = 0, norm1 = 0, norm2 = 0, normInf = 0, min = 1e9, max = -1e9;
+  for(int i = 0; i < 150; ++i) {
+    for(int j = 0; j < 101; ++j) {
+      sum += F(i, j);
+      norm1 += std::abs(F(i, j));
+      norm2 += F(i, j) * F(i, j);
+      normInf = std::max(normInf, std::abs(F(i, j)));
+      min     = std::min(min, F(i, j));
+      max     = std::max(max, F(i, j));
+    }
+  }
+
+  SECTION("Sums and norms")
+  {
+    CHECK(F.sum() == Catch::Approx(sum).margin(1e-10));
+    CHECK(F.sum(ReductionMode::Reproducible) ==
+          Catch::Approx(sum).margin(1e-10));
+    CHECK(F.norm1() == Catch::Approx(norm1));
+    CHECK(F.norm2() == Catch::Approx(std::sqrt(norm2)));
+    CHECK(F.normInf() == normInf);
+    CHECK(dot(F, F) == Catch::Approx(norm2));
+    CHECK(F.dot(F, ReductionMode::Reproducible) == Catch::Approx(norm2));
+
+    Field<double, 2> E(0, 0);
+    CHECK(E.sum() == 0);
+    CHECK(E.norm2() == 0);
+  }
+
+  SECTION("Extrema")
+  {
+    CHECK(F.min() == min);
+    CHECK(F.max() == max);
+
+    // sin(10 x) + y is largest near x = pi/20, y = 1
+    auto m = F.argmax();
+    CHECK(m.value == max);
+    CHECK(m.index[0] == 16);
+    CHECK(m.index[1] == 100);
+    CHECK(m.coord[0] == Catch::Approx(0.16));
+    CHECK(m.coord[1] == Catch::Approx(1));
+    CHECK(F(m.index[0], m.index[1]) == max);
+
+    // ties go to the first element
+    Field<int, 1> G(3 * ::detail::block_size);
+    G = 2;
+    G(5) = G(3 * ::detail::block_size - 1) = 1;
+    G(4000) = G(9000) = 7;
+    CHECK(G.argmin().index[0] == 5);
+    CHECK(G.argmax().index[0] == 4000);
+    CHECK(G.sum() == 2 * 3 * ::detail::block_size - 2 + 10);
+
+    // NaN is skipped
+    F(0, 0) = std::nan("");
+    CHECK(F.argmin().value == min);
+    CHECK(F.argmax().value == max);
+  }
+
+  SECTION("Slices")
+  {
+    auto S = F.slice(indices[IRange(10, 50)][IRange(0, 101, 3)]);
+    double s = 0, m = -1e9;
+    for(int i = 10; i < 50; ++i) {
+      for(int j = 0; j < 101; j += 3) {
+        s += F(i, j);
+        m = std::max(m, F(i, j));
+      }
+    }
+    CHECK(S.sum() == Catch::Approx(s).margin(1e-10));
+    CHECK(S.max() == m);
+    CHECK(S.argmax().index[0] == 6);
+    CHECK(S.argmax().index[1] == 33);
+  }
+
+#ifdef _OPENMP
+  SECTION("Reproducible sums do not depend on the number of threads")
+  {
+    std::mt19937                           gen(3);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Field<double, 1>                       H(100003);
+    for(size_t i = 0; i < H.size(); ++i) H(i) = std::exp(20 * dist(gen));
+
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    const double s = H.sum(ReductionMode::Reproducible);
+    const double d = H.dot(H, ReductionMode::Reproducible);
+    for(int n : {2, 3, 7}) {
+      omp_set_num_threads(n);
+      CHECK(H.sum(ReductionMode::Reproducible) == s);
+      CHECK(H.dot(H, ReductionMode::Reproducible) == d);
+    }
+    omp_set_num_threads(threads);
+  }
+#endif
+}
+
+TEST_CASE("Field Reductions Performance", "[.][benchmarks]")
+{
+  Field<double, 3> F(200, 200, 200);
+  F.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+  F.set_f([](auto x) { return x[0] - x[1] * x[2]; });
+
+  BENCHMARK("Serial Loop")
+  {
+    double s = 0;
+    for(size_t i = 0; i < F.size(); ++i) s += F.data()[i];
+    return s;
+  };
+  BENCHMARK("sum") { return F.sum(); };
+  BENCHMARK("sum Reproducible")
+  {
+    return F.sum(ReductionMode::Reproducible);
+  };
+  BENCHMARK("norm2") { return F.norm2(); };
+  BENCHMARK("argmax") { return F.argmax().value; };
+}
+
+TEST_CASE("Field::reduce_axis")
+{
+  Field<double, 3> F(7, 9, 11);
+  F.setCoordinateSystem(Uniform(0., 6.),
+                        [](size_t i, size_t N) { return 0.1 * i * i; },
+                        Uniform(-1., 1.));
+  F.set_f([](auto x) { return x[0] + 2 * x[1] * x[2] + 1; });
+
+  // brute force reduction of axis k
+  auto check = [&](size_t k, AxisReduction op, const auto& R) {
+    const auto& a = F.getAxis(k);
+    for(size_t i = 0; i < F.size(0); ++i) {
+      for(size_t j = 0; j < F.size(1); ++j) {
+        for(size_t l = 0; l < F.size(2); ++l) {
+          std::array<size_t, 3> ind{{i, j, l}};
+          if(ind[k] > 0) continue;
+          std::array<size_t, 2> rind;
+          for(size_t m = 0, n = 0; m < 3; ++m)
+            if(m != k) rind[n++] = ind[m];
+
+          double s = 0, mn = 1e9, mx = -1e9, integral = 0;
+          for(size_t m = 0; m < a.size(); ++m) {
+            ind[k]         = m;
+            const double v = F(ind);
+            s += v;
+            mn = std::min(mn, v);
+            mx = std::max(mx, v);
+            if(m > 0) {
+              auto prev = ind;
+              --prev[k];
+              integral += 0.5 * (a[m] - a[m - 1]) * (v + F(prev));
+            }
+          }
+          const double v = R(rind);
+          switch(op) {
+            case AxisReduction::Sum: CHECK(v == Catch::Approx(s)); break;
+            case AxisReduction::Mean:
+              CHECK(v == Catch::Approx(s / a.size()));
+              break;
+            case AxisReduction::Min: CHECK(v == mn); break;
+            case AxisReduction::Max: CHECK(v == mx); break;
+            case AxisReduction::Integral:
+              CHECK(v == Catch::Approx(integral));
+              break;
+          }
+        }
+      }
+    }
+  };
+
+  for(size_t k = 0; k < 3; ++k) {
+    for(auto op : {AxisReduction::Sum, AxisReduction::Mean, AxisReduction::Min,
+                   AxisReduction::Max, AxisReduction::Integral}) {
+      auto R = F.reduce_axis(k, op);
+      for(size_t m = 0, n = 0; m < 3; ++m) {
+        if(m == k) continue;
+        CHECK(R.size(n) == F.size(m));
+        CHECK(R.getAxis(n)[3] == F.getAxis(m)[3]);
+        ++n;
+      }
+      check(k, op, R);
+    }
+  }
+
+  SECTION("Closed form lookups are kept")
+  {
+    auto R = F.reduce_axis(1, AxisReduction::Sum);
+    CHECK(R.getCoordinateSystem().getAxisLookup(0).kind ==
+          decltype(R)::cs_type::AxisLookup::Kind::Uniform);
+    CHECK(R.lower_bound(2.5, 0.1)[0] == 2);
+  }
+
+  SECTION("Integrals are exact for linear functions")
+  {
+    // int_0^6.4 (x + 2 y z + 1) dy = 6.4 (x + 1) + 6.4^2 z
+    auto R = F.reduce_axis(1, AxisReduction::Integral);
+    auto x = R.getCoord(2, 7);
+    CHECK(R(2, 7) == Catch::Approx(6.4 * (x[0] + 1) + 6.4 * 6.4 * x[1]));
+  }
+
+  SECTION("Slices")
+  {
+    auto S = F.slice(indices[IRange(1, 7, 2)][IRange()][IRange(0, 11, 5)]);
+    auto R = S.reduce_axis(1, AxisReduction::Max);
+    CHECK(R.size(0) == 3);
+    CHECK(R.size(1) == 3);
+    for(int i = 0; i < 3; ++i)
+      for(int l = 0; l < 3; ++l)
+        CHECK(R(i, l) == std::max(F(2 * i + 1, 0, 5 * l), F(2 * i + 1, 8, 5 * l)));
+  }
+
+  SECTION("2D to 1D")
+  {
+    Field<int, 2> G(5 * ::detail::block_size + 3, 3);
+    G.setCoordinateSystem(Uniform(0, 1), Uniform(0, 2));
+    G.set_f([](auto x) { return 1; });
+    auto R = G.reduce_axis(1, AxisReduction::Sum);
+    CHECK(R.size() == G.size(0));
+    CHECK(R.sum() == 3 * static_cast<int>(G.size(0)));
+    CHECK(G.reduce_axis(0, AxisReduction::Sum)(2) ==
+          static_cast<int>(G.size(0)));
+  }
+
+  SECTION("Array types")
+  {
+    // owning array types are kept, others are replaced by the default ones
+    Field<double, 3, double, alignedArrayND> A(4, 5, 6);
+    A      = 1.;
+    auto R = A.reduce_axis(2, AxisReduction::Sum);
+    CHECK(std::is_same<decltype(R), Field<double, 2, double, alignedArrayND>>::value);
+    CHECK(R(3, 4) == 6);
+
+    auto S = F.slice(indices[IRange()][IRange()][IRange(0, 11, 5)]);
+    CHECK(std::is_same<decltype(S.reduce_axis(0, AxisReduction::Sum)),
+                       Field<double, 2>>::value);
+
+    typedef FixedExtents<3, 4> E;
+    Field<double, 2, double, E::arrayND, E::array1D> X(3, 4);
+    X = 2.;
+    auto RX = X.reduce_axis(0, AxisReduction::Sum);
+    CHECK(std::is_same<decltype(RX), Field<double, 1>>::value);
+    CHECK(RX(3) == 6);
+  }
+}
+
+TEST_CASE("Field::reduce_axis Performance", "[.][benchmarks]")
+{
+  Field<double, 3> F(100, 200, 300);
+  F.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+  F.set_f([](auto x) { return x[0] - x[1] * x[2]; });
+
+  for(size_t k : {0, 1, 2}) {
+    BENCHMARK("reduce_axis " + std::to_string(k))
+    {
+      return F.reduce_axis(k, AxisReduction::Sum).size();
+    };
+  }
+  BENCHMARK("Sliced Loop 1")
+  {
+    Field<double, 2> R(100, 300);
+    for(size_t i = 0; i < 100; ++i) {
+      for(size_t l = 0; l < 300; ++l) {
+        auto   S = F.slice(indices[i][IRange()][l]);
+        double s = 0;
+        for(size_t j = 0; j < S.size(); ++j) s += S(j);
+        R(i, l) = s;
+      }
+    }
+    return R.size();
+  };
+}
+
+TEST_CASE("Field::apply_stencil")
+{
+  Field<double, 2> F(12, 9), G;
+  F.setCoordinateSystem(Uniform(0., 11.),
+                        [](size_t i, size_t N) { return 0.5 * i * i; });
+  F.set_f([](auto x) { return x[0] * x[0] + 3 * x[1]; });
+
+  SECTION("Fixed")
+  {
+    F.apply_stencil(G, 1, [](const auto& n) {
+      return n(-1, 0) + n(1, 0) + n(0, -1) + n(0, 1) - 4 * n(0, 0);
+    });
+    REQUIRE(G.size() == F.size());
+    for(int i = 0; i < 12; ++i) {
+      for(int j = 0; j < 9; ++j) {
+        if(i == 0 || j == 0 || i == 11 || j == 8)
+          CHECK(G(i, j) == F(i, j));
+        else
+          CHECK(G(i, j) == Catch::Approx(F(i - 1, j) + F(i + 1, j) +
+                                         F(i, j - 1) + F(i, j + 1) -
+                                         4 * F(i, j)));
+      }
+    }
+
+    // the neighborhood gives the index and coordinates of the elements. the
+    // kernel runs on several threads, so the coordinates are recorded and
+    // checked afterwards.
+    std::vector<std::array<double, 2>> x(F.size());
+    F.apply_stencil(G, 2, [&](const auto& n) {
+      x[9 * n.index()[0] + n.index()[1]] = n.coord();
+      return (n(0, 2) - n(0, -2)) / (n.coord(1, 2) - n.coord(1, -2));
+    });
+    // (the kernel is not called within radius of the boundary)
+    for(size_t i = 2; i < 10; ++i) {
+      for(size_t j = 2; j < 7; ++j) {
+        CHECK(x[9 * i + j][0] == Catch::Approx(i));
+        CHECK(x[9 * i + j][1] == Catch::Approx(0.5 * j * j));
+      }
+    }
+    CHECK(G(5, 4) == Catch::Approx(3));
+    CHECK(G(1, 4) == F(1, 4));
+    CHECK(G(5, 1) == F(5, 1));
+  }
+
+  SECTION("Output with a different shape")
+  {
+    Field<double, 2> H(9, 12);
+    H = -1;
+    F.apply_stencil(
+        H, 1, [](const auto& n) { return n(0, 0) + 1; },
+        StencilBoundary::Clamp);
+    REQUIRE(H.size(0) == 12);
+    REQUIRE(H.size(1) == 9);
+    for(int i = 0; i < 12; ++i)
+      for(int j = 0; j < 9; ++j) CHECK(H(i, j) == Catch::Approx(F(i, j) + 1));
+  }
+
+  SECTION("Clamp")
+  {
+    F.apply_stencil(
+        G, 1,
+        [](const auto& n) {
+          return (n(1, 0) - n(-1, 0)) / (n.coord(0, 1) - n.coord(0, -1));
+        },
+        StencilBoundary::Clamp);
+    // the coordinates are extrapolated, but the elements are clamped
+    CHECK(G(0, 3) == Catch::Approx((F(1, 3) - F(0, 3)) / 2));
+    CHECK(G(11, 3) == Catch::Approx((F(11, 3) - F(10, 3)) / 2));
+    CHECK(G(5, 3) == Catch::Approx(10));
+  }
+
+  SECTION("Periodic")
+  {
+    Field<double, 1> P(10), Q;
+    P.setCoordinateSystem(Uniform(0., 9.));
+    P.set_f([](auto x) { return x[0] * x[0]; });
+    std::vector<double> dx(10);
+    P.apply_stencil(
+        Q, 1,
+        [&](const auto& n) {
+          dx[n.index()[0]] = n.coord(0, 1) - n.coord(0, -1);
+          return n(-1) + n(1);
+        },
+        StencilBoundary::Periodic);
+    for(int i = 0; i < 10; ++i) CHECK(dx[i] == Catch::Approx(2));
+    CHECK(Q(0) == Catch::Approx(81 + 1));
+    CHECK(Q(4) == Catch::Approx(9 + 25));
+    CHECK(Q(9) == Catch::Approx(64 + 0));
+  }
+
+  SECTION("Slices")
+  {
+    Field<double, 3> A(4, 5, 6), B(A);
+    A.setCoordinateSystem(Uniform(0., 3.), Uniform(0., 4.), Uniform(0., 5.));
+    A.set_f([](auto x) { return x[0] + 10 * x[1] + 100 * x[2]; });
+    B = 0.0;
+    auto SA = A.slice(indices[IRange()][2][IRange(0, 6, 2)]);
+    auto SB = B.slice(indices[IRange()][1][IRange(1, 6, 2)]);
+    SA.apply_stencil(
+        SB, 1, [](const auto& n) { return n(0, 1) - n(0, 0) + n.coord(0); },
+        StencilBoundary::Clamp);
+    for(int i = 0; i < 4; ++i) {
+      CHECK(B(i, 1, 1) == Catch::Approx(200 + i));
+      CHECK(B(i, 1, 3) == Catch::Approx(200 + i));
+      CHECK(B(i, 1, 5) == Catch::Approx(i));
+      CHECK(B(i, 2, 1) == 0);
+    }
+  }
+
+  SECTION("Iterate")
+  {
+    // explicit heat equation steps, with double buffering
+    Field<double, 2> T(40, 50), T1(T), T2(T);
+    T.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.));
+    T.set_f([](auto x) { return x[0] * (1 - x[0]) * x[1]; });
+    T1 = T;
+    auto step = [](const auto& n) {
+      return n(0, 0) +
+             0.2 * (n(-1, 0) + n(1, 0) + n(0, -1) + n(0, 1) - 4 * n(0, 0));
+    };
+    // the result ends up in the field's own elements (after an odd number
+    // of steps too), so slices taken before refer to it
+    auto  row = T.slice(indices[7][IRange()]);
+    auto* p   = T.data();
+    T.iterate_stencil(5, 1, step);
+    for(int s = 0; s < 5; ++s) {
+      T1.apply_stencil(T2, 1, step);
+      std::swap(T1, T2);
+    }
+    CHECK(T.data() == p);
+    for(size_t i = 0; i < T.size(); ++i)
+      CHECK(T.data()[i] == T1.data()[i]);
+    for(int j = 0; j < 50; ++j) CHECK(row(j) == T1(7, j));
+    CHECK(T(0, 10) == 0);
+  }
+}
+
+TEST_CASE("Field::apply_stencil Performance", "[.][benchmarks]")
+{
+  Field<double, 3> T(200, 200, 200), T2(T);
+  T.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.), Uniform(0., 1.));
+  T.set_f([](auto x) { return x[0] * x[1] * x[2]; });
+
+  BENCHMARK("set_f(ind, cs)")
+  {
+    T2.set_f([&](const auto& ind, auto cs) {
+      const int i = ind[0], j = ind[1], k = ind[2];
+      if(i == 0 || j == 0 || k == 0 || i == 199 || j == 199 || k == 199)
+        return T(i, j, k);
+      return T(i, j, k) +
+             0.1 * (T(i + 1, j, k) + T(i - 1, j, k) + T(i, j + 1, k) +
+                    T(i, j - 1, k) + T(i, j, k + 1) + T(i, j, k - 1) -
+                    6 * T(i, j, k));
+    });
+    return T2(1, 1, 1);
+  };
+  BENCHMARK("apply_stencil")
+  {
+    T.apply_stencil(T2, 1, [](const auto& n) {
+      return n(0, 0, 0) + 0.1 * (n(1, 0, 0) + n(-1, 0, 0) + n(0, 1, 0) +
+                                 n(0, -1, 0) + n(0, 0, 1) + n(0, 0, -1) -
+                                 6 * n(0, 0, 0));
+    });
+    return T2(1, 1, 1);
+  };
 }
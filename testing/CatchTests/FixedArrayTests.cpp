@@ -0,0 +1,129 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libField/Field.hpp>
+
+TEST_CASE("FixedArray")
+{
+  FixedArray<double, 3, 4, 5> A;
+  CHECK(A.num_elements() == 60);
+  CHECK(A.extent(0) == 3);
+  CHECK(A.extent(2) == 5);
+  CHECK(A.shape()[1] == 4);
+  CHECK(A.strides()[0] == 20);
+  CHECK(A.strides()[1] == 5);
+  CHECK(A.data()[17] == 0);
+
+  std::array<int, 3> ind{{2, 1, 3}};
+  A(ind)      = 7;
+  A[1][2][3]  = 8;
+  CHECK(A.data()[2 * 20 + 1 * 5 + 3] == 7);
+  CHECK(A.data()[1 * 20 + 2 * 5 + 3] == 8);
+  CHECK(A[2][1][3] == 7);
+
+  // copies have their own elements
+  FixedArray<double, 3, 4, 5> B(A);
+  CHECK(B.data() != A.data());
+  CHECK(B(ind) == 7);
+  B(ind) = 1;
+  CHECK(A(ind) == 7);
+  A = B;
+  CHECK(A(ind) == 1);
+
+  FixedCapacityArray1D<float, 10> x(boost::extents[6]);
+  CHECK(x.size() == 6);
+  x[5] = 2;
+  FixedCapacityArray1D<float, 10> y(x);
+  CHECK(y.size() == 6);
+  CHECK(y[5] == 2);
+}
+
+TEST_CASE("Fixed Extent Field")
+{
+  typedef FixedExtents<8, 16> E;
+  typedef Field<double, 2, double, E::arrayND, E::array1D> FixedField;
+
+  FixedField F(8, 16);
+  F.setCoordinateSystem(Uniform(0., 7.), Uniform(-1., 1.));
+  CHECK(F.size() == 128);
+  CHECK(F.getAxis(0).size() == 8);
+  CHECK(F.getAxis(1).size() == 16);
+  CHECK(F.getCoord(7, 15)[0] == Catch::Approx(7));
+  CHECK(F.getCoord(7, 15)[1] == Catch::Approx(1));
+
+  F.set_f([](auto x) { return x[0] * x[1]; });
+  CHECK(F(3, 15) == Catch::Approx(3));
+  CHECK(F(7, 0) == Catch::Approx(-7));
+
+  // the usual field operations work on fixed fields
+  FixedField G(F);
+  CHECK(G.data() != F.data());
+  G = 2 * F + 1.;
+  CHECK(G(3, 15) == Catch::Approx(7));
+  G += F;
+  CHECK(G(3, 15) == Catch::Approx(10));
+  CHECK(G.max() == Catch::Approx(22));
+  CHECK(F.sum() == Catch::Approx(0).margin(1e-10));
+
+  auto S = G.slice(indices[3][IRange()]);
+  CHECK(S.size() == 16);
+  CHECK(S(15) == Catch::Approx(10));
+
+  auto R = G.reduce_axis(0, AxisReduction::Sum);
+  CHECK(R.size() == 16);
+  CHECK(R(15) == Catch::Approx(2 * 28 + 8 + 28));
+
+  // the field can be reallocated with the same shape
+  F.reset(8, 16);
+  CHECK(F.size() == 128);
+}
+
+TEST_CASE("Fixed Extent Field Performance", "[.][benchmarks]")
+{
+  typedef FixedExtents<64, 64> E;
+  Field<double, 2>                                   D(64, 64);
+  Field<double, 2, double, E::arrayND, E::array1D>   F(64, 64);
+  D.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.));
+  F.setCoordinateSystem(Uniform(0., 1.), Uniform(0., 1.));
+  D.set_f([](auto x) { return x[0] * x[1]; });
+  F.set_f([](auto x) { return x[0] * x[1]; });
+
+  BENCHMARK("multi_array 64x64 loop")
+  {
+    double s = 0;
+    for(int i = 0; i < 64; ++i)
+      for(int j = 0; j < 64; ++j) s += D(i, j) * D(j, i);
+    return s;
+  };
+  BENCHMARK("FixedArray 64x64 loop")
+  {
+    double s = 0;
+    for(int i = 0; i < 64; ++i)
+      for(int j = 0; j < 64; ++j) s += F(i, j) * F(j, i);
+    return s;
+  };
+
+  Field<double, 3>            K(3, 3, 3);
+  FixedArray<double, 3, 3, 3> KF;
+  K = 1.;
+  std::fill(KF.data(), KF.data() + KF.num_elements(), 1.);
+
+  BENCHMARK("multi_array 3x3x3 kernel")
+  {
+    double s = 0;
+    for(int i = 0; i < 3; ++i)
+      for(int j = 0; j < 3; ++j)
+        for(int k = 0; k < 3; ++k) s += K(i, j, k);
+    return s;
+  };
+  BENCHMARK("FixedArray 3x3x3 kernel")
+  {
+    double s = 0;
+    std::array<int, 3> ind;
+    for(ind[0] = 0; ind[0] < 3; ++ind[0])
+      for(ind[1] = 0; ind[1] < 3; ++ind[1])
+        for(ind[2] = 0; ind[2] < 3; ++ind[2]) s += KF(ind);
+    return s;
+  };
+}
@@ -92,6 +92,15 @@ TEST_CASE("HDF5 Read and Write")
       CHECK(G(9, 0) == Catch::Approx(4));
       CHECK(G(0, 19) == Catch::Approx(16));
       CHECK(G(9, 19) == Catch::Approx(20));
+
+      // reading a field of the same shape again reuses the storage
+      const float* data = G.data();
+      F *= 2;
+      hdf5write("2D-Field.h5", F);
+      hdf5read("2D-Field.h5", G);
+      CHECK(G.data() == data);
+      CHECK(G.getCoord(9, 0)[0] == Catch::Approx(2));
+      CHECK(G(9, 19) == Catch::Approx(40));
     }
 
     SECTION("float out double in")
@@ -432,4 +441,61 @@ TEST_CASE("HDF5 Read and Write")
     CHECK(_2DF.getAxis(1)[9] == Catch::Approx(2));
   }
 }
+
+TEST_CASE("HDF5 Read and Write MultiField")
+{
+  MultiField<double, 2, 3> M(4, 6);
+  M.setCoordinateSystem(Uniform(0, 3), Uniform(0, 10));
+  M.setNames({"T", "rho", ""});
+  M[0].set_f([](auto x) { return x[0] * x[1]; });
+  M[1] = 2.;
+  M[2].set_f([](auto x) { return x[0] + x[1]; });
+
+  hdf5write("MultiField.h5", M);
+
+  // components can be read into a field, by name
+  H5::H5File       file("MultiField.h5", H5F_ACC_RDONLY);
+  auto             dset = file.openDataSet("field 2");
+  Field<double, 2> F;
+  hdf5read(dset, F);
+  file.close();
+  CHECK(F(3, 5) == Catch::Approx(3 + 10));
+
+  MultiField<float, 2, 3> N;
+  N.setNames({"T", "rho", ""});
+  hdf5read("MultiField.h5", N);
+  CHECK(N.size(0) == 4);
+  CHECK(N.size(1) == 6);
+  CHECK(N.getCoord(3, 5)[0] == Catch::Approx(3));
+  CHECK(N.getCoord(3, 5)[1] == Catch::Approx(10));
+  CHECK(N["T"](3, 5) == Catch::Approx(30));
+  CHECK(N["rho"](1, 2) == Catch::Approx(2));
+  CHECK(N[2](2, 1) == Catch::Approx(4));
+
+  MultiField<float, 2, 3> P;
+  CHECK_THROWS(hdf5read("MultiField.h5", P));
+}
+
+TEST_CASE("HDF5 Read and Write NDArray Field")
+{
+  Field<double, 2, double, nativeArrayND> F(4, 6);
+  F.setCoordinateSystem(Uniform(0, 3), Uniform(0, 10));
+  F.set_f([](auto x) { return x[0] * x[1]; });
+
+  hdf5write("NDArrayField.h5", F);
+
+  // fields written with one array type can be read into another
+  Field<double, 2> G;
+  hdf5read("NDArrayField.h5", G);
+  CHECK(G.size(0) == 4);
+  CHECK(G.size(1) == 6);
+  CHECK(G.getCoord(3, 5)[1] == Catch::Approx(10));
+  CHECK(G(3, 5) == Catch::Approx(30));
+
+  Field<float, 2, double, nativeArrayND> H;
+  hdf5read("NDArrayField.h5", H);
+  CHECK(H.size(0) == 4);
+  CHECK(H.size(1) == 6);
+  CHECK(H(2, 1) == Catch::Approx(4));
+}
 #endif
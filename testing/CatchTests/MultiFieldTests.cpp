@@ -0,0 +1,116 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <libField/Field.hpp>
+#include <stdexcept>
+
+TEST_CASE("MultiField")
+{
+  MultiField<double, 2, 3> M(5, 7);
+  M.setCoordinateSystem(Uniform(0., 4.), Uniform(0., 6.));
+  M.setNames({"T", "rho", "c"});
+
+  CHECK(M.components() == 3);
+  CHECK(M.size() == 35);
+  CHECK(M.size(0) == 5);
+  CHECK(M.size(1) == 7);
+
+  SECTION("Components share one block and coordinate system")
+  {
+    for(size_t k = 0; k < 3; ++k) {
+      CHECK(M[k].size() == 35);
+      CHECK(&M[k].getCoordinateSystem() == &M.getCoordinateSystem());
+      CHECK(M[k].data() == M.data() + k * M.component_stride());
+      CHECK(reinterpret_cast<std::uintptr_t>(M[k].data()) % 64 == 0);
+      CHECK(M[k].getCoord(2, 3)[0] == Catch::Approx(2));
+      CHECK(M[k].getCoord(2, 3)[1] == Catch::Approx(3));
+    }
+    CHECK(M.component_stride() >= M.size());
+
+    CHECK(&M["T"] == &M[0]);
+    CHECK(&M["c"] == &M[2]);
+    CHECK(M.index("rho") == 1);
+    CHECK_THROWS_AS(M["kappa"], std::out_of_range);
+  }
+
+  SECTION("Components are fields")
+  {
+    M["T"].set_f([](auto x) { return x[0] + x[1]; });
+    M["rho"] = 2.;
+    M["c"]   = M["T"] * M["rho"] + 1.;
+    for(int i = 0; i < 5; ++i) {
+      for(int j = 0; j < 7; ++j) {
+        CHECK(M[0](i, j) == Catch::Approx(i + j));
+        CHECK(M[2](i, j) == Catch::Approx(2 * (i + j) + 1));
+      }
+    }
+    CHECK(M["c"].max() == Catch::Approx(21));
+
+    // copies of components refer to the same elements
+    auto T = M["T"];
+    T(1, 1) = -1;
+    CHECK(M["T"](1, 1) == -1);
+
+    // assigning a component copies the elements
+    M[1] = 3.;
+    M[0] = M[1];
+    CHECK(M[0].data() == M.data());
+    CHECK(M[0](3, 4) == 3);
+    M[0] = 5.;
+    CHECK(M[1](3, 4) == 3);
+  }
+
+  SECTION("Copies of components keep the elements alive")
+  {
+    MultiField<double, 2, 3>::field_type c;
+    {
+      MultiField<double, 2, 2> N(3, 4);
+      N[0] = 7.;
+      c    = N[0];
+    }
+    CHECK(c.size() == 12);
+    CHECK(c(2, 3) == 7);
+  }
+
+  SECTION("Fused iteration")
+  {
+    M[0] = 1.;
+    M[1] = 2.;
+    M[2] = 3.;
+    M.for_each([](double& T, double& rho, double c) {
+      T += rho * c;
+      rho = 0;
+    });
+    for(size_t i = 0; i < M.size(); ++i) {
+      CHECK(M[0].data()[i] == 7);
+      CHECK(M[1].data()[i] == 0);
+      CHECK(M[2].data()[i] == 3);
+    }
+  }
+
+  SECTION("Copies")
+  {
+    M[1] = 4.;
+    MultiField<double, 2, 3> C(M);
+    CHECK(C.getName(1) == "rho");
+    CHECK(C["rho"](2, 2) == 4);
+    CHECK(C["rho"].getCoord(4, 6)[1] == Catch::Approx(6));
+    CHECK(C.data() != M.data());
+    CHECK(&C.getCoordinateSystem() != &M.getCoordinateSystem());
+    C["rho"] = 5.;
+    CHECK(M["rho"](2, 2) == 4);
+
+    MultiField<double, 2, 3> D;
+    D = C;
+    CHECK(D["rho"](2, 2) == 5);
+    CHECK(D[1].data() == D.data() + D.component_stride());
+  }
+
+  SECTION("Shared coordinate system")
+  {
+    Field<double, 2>            F(5, 7);
+    MultiField<double, 2, 2>    N(F.getCoordinateSystemPtr());
+    CHECK(&N.getCoordinateSystem() == &F.getCoordinateSystem());
+    CHECK(N.size() == 35);
+  }
+}
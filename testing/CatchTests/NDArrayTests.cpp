@@ -0,0 +1,146 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <libField/Field.hpp>
+#include <vector>
+
+TEST_CASE("NDArray")
+{
+  NDArray<double, 3> A(boost::extents[3][4][5]);
+  CHECK(A.num_elements() == 60);
+  CHECK(A.shape()[0] == 3);
+  CHECK(A.shape()[2] == 5);
+  CHECK(A.strides()[0] == 20);
+  CHECK(A.strides()[1] == 5);
+  CHECK(A.data()[17] == 0);
+  CHECK(reinterpret_cast<std::uintptr_t>(A.data()) % 64 == 0);
+
+  std::vector<int> ind{2, 1, 3};
+  A(ind)     = 7;
+  A(1, 2, 3) = 8;
+  CHECK(A.data()[2 * 20 + 1 * 5 + 3] == 7);
+  CHECK(A.data()[1 * 20 + 2 * 5 + 3] == 8);
+  CHECK(A[2][1][3] == 7);
+  CHECK(A(2, 1, 3) == 7);
+
+  // copies have their own elements
+  NDArray<double, 3> B(A);
+  CHECK(B.data() != A.data());
+  CHECK(B(ind) == 7);
+  B(ind) = 1;
+  CHECK(A(ind) == 7);
+  A = B;
+  CHECK(A(ind) == 1);
+
+  // moves take the elements
+  const double*      p = B.data();
+  NDArray<double, 3> C(std::move(B));
+  CHECK(C.data() == p);
+  CHECK(C(ind) == 1);
+  CHECK(B.num_elements() == 0);
+
+  // resizing does not keep elements
+  C.resize(std::array<size_t, 3>{{2, 2, 2}});
+  CHECK(C.num_elements() == 8);
+  CHECK(C.strides()[0] == 4);
+  CHECK(C(1, 1, 1) == 0);
+
+  // views work as they do for a multi_array
+  typedef boost::multi_array_types::index_range range;
+  auto V = A[boost::indices[2][range(1, 3)][range()]];
+  CHECK(V.shape()[0] == 2);
+  CHECK(V.shape()[1] == 5);
+  CHECK(V[0][3] == 1);
+
+  NDArray<int, 1> D;
+  CHECK(D.num_elements() == 0);
+  D.resize(boost::extents[4]);
+  D(3) = 2;
+  CHECK(D[3] == 2);
+}
+
+TEST_CASE("NDArray Field")
+{
+  typedef Field<double, 2, double, nativeArrayND> NativeField;
+
+  NativeField F(5, 7);
+  F.setCoordinateSystem(Uniform(0., 4.), Uniform(0., 6.));
+  F.set_f([](auto x) { return x[0] * x[1]; });
+  CHECK(F(3, 5) == Catch::Approx(15));
+  CHECK(F[3][5] == Catch::Approx(15));
+
+  NativeField G(F);
+  CHECK(G.data() != F.data());
+  G = 2 * F + 1.;
+  CHECK(G(3, 5) == Catch::Approx(31));
+  G += F;
+  CHECK(G(3, 5) == Catch::Approx(46));
+  CHECK(G.max() == Catch::Approx(3 * 24 + 1));
+
+  auto S = G.slice(indices[3][IRange()]);
+  CHECK(S.size() == 7);
+  CHECK(S(5) == Catch::Approx(46));
+  S = 0.;
+  CHECK(G(3, 5) == 0);
+
+  auto R = F.reduce_axis(0, AxisReduction::Sum);
+  CHECK(R.size() == 7);
+  CHECK(R(6) == Catch::Approx(10 * 6));
+
+  // the field can be reallocated with a different shape
+  F.reset(3, 3);
+  CHECK(F.size() == 9);
+  F = 1.;
+  CHECK(F.sum() == Catch::Approx(9));
+
+  NativeField H;
+  H.setCopyOnWrite(true);
+  H = G;
+  CHECK(H(4, 6) == Catch::Approx(G(4, 6)));
+}
+
+TEST_CASE("NDArray Field Performance", "[.][benchmarks]")
+{
+  const int                               N = 100;
+  Field<double, 3>                        D(N, N, N);
+  Field<double, 3, double, nativeArrayND> F(N, N, N);
+  D = 1.;
+  F = 1.;
+
+  BENCHMARK("multi_array T(i,j,k)")
+  {
+    double s = 0;
+    for(int i = 0; i < N; ++i)
+      for(int j = 0; j < N; ++j)
+        for(int k = 0; k < N; ++k) s += D(i, j, k);
+    return s;
+  };
+  BENCHMARK("NDArray T(i,j,k)")
+  {
+    double s = 0;
+    for(int i = 0; i < N; ++i)
+      for(int j = 0; j < N; ++j)
+        for(int k = 0; k < N; ++k) s += F(i, j, k);
+    return s;
+  };
+
+  std::vector<int> I(3);
+  BENCHMARK("multi_array T(I)")
+  {
+    double s = 0;
+    for(I[0] = 0; I[0] < N; ++I[0])
+      for(I[1] = 0; I[1] < N; ++I[1])
+        for(I[2] = 0; I[2] < N; ++I[2]) s += D(I);
+    return s;
+  };
+  BENCHMARK("NDArray T(I)")
+  {
+    double s = 0;
+    for(I[0] = 0; I[0] < N; ++I[0])
+      for(I[1] = 0; I[1] < N; ++I[1])
+        for(I[2] = 0; I[2] < N; ++I[2]) s += F(I);
+    return s;
+  };
+}
@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <libField/Field.hpp>
+#include <vector>
+
+#include "Utils.h"
+
+template<typename T, typename K>
+void check_kernel(K kernel)
+{
+  // use sizes that are not multiples of the vector width
+  for(size_t n : {0, 1, 3, 7, 17, 37, 64, 100}) {
+    std::vector<T> a(n), b(n);
+    for(size_t i = 0; i < n; ++i) {
+      a[i] = i;
+      b[i] = 2 * i + 1;
+    }
+    kernel(a.data(), b.data(), n);
+    for(size_t i = 0; i < n; ++i)
+      CHECK(a[i] == Catch::Approx((3. * i + 2) * 0.5));
+  }
+}
+
+TEST_CASE("SIMD Kernels")
+{
+  auto op = [](auto& x, const auto& y) {
+    x += y;
+    x += 1;
+    x *= 0.5;
+  };
+
+  SECTION("Dispatched")
+  {
+    check_kernel<double>([&](double* a, const double* b, size_t n) {
+      simd_kernels::apply_array(a, b, n, op);
+    });
+    check_kernel<float>([&](float* a, const float* b, size_t n) {
+      simd_kernels::apply_array(a, b, n, op);
+    });
+  }
+
+#if LIBFIELD_SIMD_X86
+  SECTION("SSE2")
+  {
+    check_kernel<double>([&](double* a, const double* b, size_t n) {
+      simd_kernels::apply_array_sse2(a, b, n, op);
+    });
+    check_kernel<float>([&](float* a, const float* b, size_t n) {
+      simd_kernels::apply_array_sse2(a, b, n, op);
+    });
+  }
+  SECTION("AVX2")
+  {
+    if(__builtin_cpu_supports("avx2")) {
+      check_kernel<double>([&](double* a, const double* b, size_t n) {
+        simd_kernels::apply_array_avx2(a, b, n, op);
+      });
+      check_kernel<float>([&](float* a, const float* b, size_t n) {
+        simd_kernels::apply_array_avx2(a, b, n, op);
+      });
+    }
+  }
+  SECTION("AVX-512")
+  {
+    if(__builtin_cpu_supports("avx512f")) {
+      check_kernel<double>([&](double* a, const double* b, size_t n) {
+        simd_kernels::apply_array_avx512(a, b, n, op);
+      });
+      check_kernel<float>([&](float* a, const float* b, size_t n) {
+        simd_kernels::apply_array_avx512(a, b, n, op);
+      });
+    }
+  }
+#endif
+
+  SECTION("Scalar")
+  {
+    std::vector<double> a(37);
+    for(size_t i = 0; i < a.size(); ++i) a[i] = i;
+    simd_kernels::apply_value(a.data(), 2., a.size(),
+                              [](auto& x, const auto& v) { x *= v; });
+    for(size_t i = 0; i < a.size(); ++i) CHECK(a[i] == Catch::Approx(2. * i));
+  }
+}
+
+TEST_CASE("Vectorized Field Operators")
+{
+  SECTION("float field with double scalars")
+  {
+    Field<float, 1> F(37), G(37);
+    for(int i = 0; i < 37; ++i) F(i) = G(i) = i + 0.3f;
+
+    // 0.5 is exactly representable as a float, so this uses the kernels.
+    F *= 0.5;
+    // 0.1 is not, so this falls back to computing in double.
+    F += 0.1;
+    for(int i = 0; i < 37; ++i) {
+      G(i) *= 0.5;
+      G(i) += 0.1;
+      CHECK(F(i) == G(i));
+    }
+  }
+
+  SECTION("double field with int scalars")
+  {
+    Field<double, 2> F(5, 9), G(5, 9);
+    F = 3;
+    G.set(1);
+    F -= G;
+    F /= 4;
+    for(int i = 0; i < 5; ++i)
+      for(int j = 0; j < 9; ++j) CHECK(F(i, j) == Catch::Approx(0.5));
+  }
+}
+
+TEST_CASE("SIMD Kernels vs. Plain Loops", "[.][benchmarks]")
+{
+  Field<double, 3> F(64, 64, 64), G(F);
+  F = 1.0;
+  G = 2.0;
+
+  BENCHMARK("Field += Field") { return (F += G).size(); };
+  BENCHMARK("Field *= Scalar") { return (F *= 1.0).size(); };
+  BENCHMARK("Plain Loop +=")
+  {
+    simd_kernels::apply_array_scalar(F.data(), G.data(), F.size(),
+                                     [](auto& x, const auto& y) { x += y; });
+    return F.size();
+  };
+}
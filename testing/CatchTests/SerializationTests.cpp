@@ -165,6 +165,30 @@ TEST_CASE("MultiArray Serialization - 3D")
   }
 }
 
+TEST_CASE("NDArray Serialization")
+{
+  NDArray<double, 3> a(extents[4][5][6]), b;
+  for(size_t i = 0; i < a.num_elements(); ++i) a.data()[i] = 0.5 * i;
+
+  std::stringstream             ss;
+  boost::archive::text_oarchive oa(ss);
+  oa << a;
+
+  boost::archive::text_iarchive ia(ss);
+  ia >> b;
+
+  CHECK(b.shape()[0] == 4);
+  CHECK(b.shape()[1] == 5);
+  CHECK(b.shape()[2] == 6);
+  for(int i = 0; i < 4; i++) {
+    for(int j = 0; j < 5; j++) {
+      for(int k = 0; k < 6; k++) {
+        CHECK(b(i, j, k) == a(i, j, k));
+      }
+    }
+  }
+}
+
 TEST_CASE("CoordinateSystem Serialization")
 {
   CoordinateSystem<double, 3> Coordinates(11, 11, 11);